@@ -0,0 +1,79 @@
+// Bench
+// ------------------------------------------------------------------
+// Vixen Programming Language benchmarking tools.
+// ------------------------------------------------------------------
+// A small companion to Hounddog. Where Hounddog asserts on the
+// behavior of our internal API, this header measures how quickly
+// that API does its work.
+#pragma once
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "tests/ggm.hpp"
+
+namespace bench {
+    typedef void(*BenchCaseFunc)(void);
+
+    // Benchmark runtime registry.
+    struct BenchRunStats {
+        std::map<std::string, BenchCaseFunc> registry;
+    };
+
+    // Add a benchmark to the registry.
+    void add_bench(
+        BenchRunStats& brs,
+        const std::string& id,
+        BenchCaseFunc bc) {
+
+        brs.registry[id] = bc;
+    }
+
+    // Time a workload over a number of rounds and
+    // write the best round to stdout. `bytes`, if
+    // non-zero, is the amount of input consumed per
+    // round and is reported as throughput.
+    double measure(
+        const std::string& label,
+        size_t bytes,
+        uint rounds,
+        const std::function<void()>& workload) {
+
+        double best = 0;
+        for (uint i = 0; i < rounds; i++) {
+            auto start = std::chrono::steady_clock::now();
+            workload();
+            auto stop  = std::chrono::steady_clock::now();
+
+            double elapsed = std::chrono::duration<double>(stop - start).count();
+            if (i == 0 || elapsed < best)
+                best = elapsed;
+        }
+
+        std::cout
+            << "  " << std::left << std::setw(40) << label
+            << std::right << std::fixed << std::setprecision(3)
+            << std::setw(10) << best * 1e3 << " ms";
+        if (bytes)
+            std::cout
+                << std::setw(12) << (bytes / best) / (1024.0 * 1024.0)
+                << " MB/s";
+        std::cout << std::endl;
+
+        return best;
+    }
+
+    // Run every registered benchmark whos id
+    // matches the pattern.
+    void attempt(BenchRunStats& brs, const std::string& pattern) {
+        for (auto const& [id, bc] : brs.registry) {
+            if (!ggm::gitignore_glob_match(id.c_str(), pattern.c_str()))
+                continue;
+            std::cout << id << std::endl;
+            bc();
+        }
+    }
+}
@@ -0,0 +1,6 @@
+#include "vixen/bench_symbols.hpp"
+#include "vixen/bench_tokens.hpp"
+#include "vixen/bench_sources.hpp"
+#include "vixen/bench_parser.hpp"
+#include "vixen/bench_cache.hpp"
+#include "vixen/bench_incremental.hpp"
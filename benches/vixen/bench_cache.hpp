@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdio>
+
+#include "benches/bench.hpp"
+#include "benches/vixen/corpus.hpp"
+#include "include/vixen/cache.hpp"
+
+namespace bench_vixen::cache {
+    using namespace vixen::cache;
+
+    // Lexing a whole source, compared to loading
+    // its tokens from a cache.
+    void bench_cache_load() {
+        auto source = vixen::sources::source_from_string(corpus::setup_corpus());
+        size_t length = source->view().length();
+        std::string file_name = "/tmp/vixen_bench_cache.vxt";
+        cache_write(TokenStream(source), file_name);
+
+        bench::measure("TokenStream (lex)", length, 5, [&]() {
+            TokenStream stream(source);
+        });
+        bench::measure("cache_load", length, 5, [&]() {
+            cache_load(source, file_name);
+        });
+        std::remove(file_name.c_str());
+    }
+}
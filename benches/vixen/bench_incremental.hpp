@@ -0,0 +1,41 @@
+#pragma once
+#include "benches/bench.hpp"
+#include "benches/vixen/corpus.hpp"
+#include "include/vixen/incremental.hpp"
+
+namespace bench_vixen::incremental {
+    using namespace vixen::incremental;
+
+    // Bringing a tree up to date after a one
+    // byte edit in the middle of a large
+    // program, compared to parsing it again from
+    // scratch.
+    void bench_edit_latency() {
+        std::string corpus = corpus::setup_expressions();
+        auto source = vixen::sources::source_from_string(corpus);
+        volatile size_t sink = 0;
+
+        bench::measure("parse (full)", corpus.length(), 5, [&]() {
+            TreeParser p{Lexer(source)};
+            sink = parse(p).arena.nodes();
+        });
+
+        // Swap a name back and forth, so the text
+        // keeps its length.
+        IncrementalTree tree(source);
+        vixen::sources::Offset at = corpus.find("x + y", corpus.length() / 2);
+        bool swapped = false;
+        EditStats stats;
+
+        bench::measure("edit (incremental)", corpus.length(), 5, [&]() {
+            swapped = !swapped;
+            stats   = tree.edit(TextEdit{at, at + 1, swapped ? "w" : "x"});
+            sink    = stats.reparsed;
+        });
+        std::cout
+            << "  reparsed: " << stats.reparsed
+            << ", reused: " << stats.reused
+            << ", relexed: " << stats.relexed << " bytes"
+            << std::endl;
+    }
+}
@@ -0,0 +1,185 @@
+#pragma once
+#include "benches/bench.hpp"
+#include "benches/vixen/corpus.hpp"
+#include "include/vixen/parser.hpp"
+
+namespace bench_vixen::parser {
+    using namespace vixen::parser;
+
+    // Parse through the dynamic interface. Kept
+    // out of line so every call is dispatched
+    // through the vtable.
+    __attribute__((noinline))
+    Tree parse_dynamic(Parser& parser) {
+        return parse(parser);
+    }
+
+    // Tree parsing throughput with the parser
+    // dispatched statically, and through its
+    // dynamic adapter.
+    void bench_parser_dispatch() {
+        std::string corpus = corpus::setup_expressions();
+
+        bench::measure("parse (static)", corpus.length(), 5, [&]() {
+            TreeParser p{Lexer(corpus)};
+            parse(p);
+        });
+        bench::measure("parse (dynamic)", corpus.length(), 5, [&]() {
+            DynamicParser<TreeParser> p{TreeParser(Lexer(corpus))};
+            parse_dynamic(p);
+        });
+    }
+
+    // Tree building alone, parsing from tokens
+    // lexed up front, and how much of the arena
+    // the tree takes up.
+    void bench_parser_arena() {
+        auto source = vixen::sources::source_from_string(corpus::setup_expressions(4 << 20));
+        auto stream = std::make_shared<const TokenStream>(source);
+        volatile size_t sink = 0;
+
+        bench::measure("parse (token stream)", source->view().length(), 5, [&]() {
+            TreeParser p(stream);
+            sink = parse(p).arena.nodes();
+        });
+
+        TreeParser p(stream);
+        Tree tree = parse(p);
+        std::cout
+            << "  nodes: " << tree.arena.nodes()
+            << ", arena: " << tree.arena.bytes() / 1024 << " KiB"
+            << std::endl;
+    }
+
+    // Sum of the token offsets in a subtree,
+    // following child pointers.
+    size_t walk_tree(const TreeNode* node) {
+        size_t sum = node->token_get().offset;
+        for (const TreeNode* stmt : node->body_get())
+            sum += walk_tree(stmt);
+        for (NodeSlot slot : {NodeSlot::Value, NodeSlot::Left, NodeSlot::Right}) {
+            if (node->child_get(slot))
+                sum += walk_tree(node->child_get(slot));
+        }
+        return sum;
+    }
+
+    // Bytes per node, and time to visit every
+    // node, of a tree of pointers compared to
+    // the same tree laid out flat.
+    void bench_parser_flat() {
+        auto source = vixen::sources::source_from_string(corpus::setup_expressions(4 << 20));
+        auto stream = std::make_shared<const TokenStream>(source);
+        volatile size_t sink = 0;
+
+        TreeParser p(stream);
+        Tree     tree = parse(p);
+        FlatTree flat;
+
+        bench::measure("flat_from_tree", 0, 5, [&]() {
+            flat = flat_from_tree(tree.root, stream);
+        });
+        bench::measure("visit (pointers)", 0, 5, [&]() {
+            sink = walk_tree(tree.root);
+        });
+        bench::measure("visit (flat)", 0, 5, [&]() {
+            size_t sum = 0;
+            for (const FlatNode& node : flat.nodes) {
+                if (node.token != NODE_NONE)
+                    sum += stream->offset(node.token);
+            }
+            sink = sum;
+        });
+
+        std::cout
+            << "  nodes: " << flat.size()
+            << ", bytes/node (arena): " << tree.arena.bytes() / tree.arena.nodes()
+            << ", (flat): " << flat.bytes() / flat.size()
+            << std::endl;
+    }
+
+    // Hands out tokens made up front, so only
+    // the cost of building the tree is measured.
+    class TokenSpanParser {
+        private:
+            std::span<const Token> tokens;
+            vixen::sources::SourceRef source;
+            vixen::numerics::NumericTable numerics;
+            size_t head = 0;
+            Diagnostics reports;
+
+            const Token& at(size_t index) {
+                return this->tokens[std::min(index, this->tokens.size() - 1)];
+            }
+
+        public:
+            TokenSpanParser(std::span<const Token> tokens, vixen::sources::SourceRef source) : tokens(tokens), source(source) {
+                this->numerics = tokens_decode_numerics(tokens);
+            }
+
+            const Token& current() {
+                return this->at(this->head);
+            }
+
+            const Token& previous() {
+                return this->at(this->head ? this->head - 1 : 0);
+            }
+
+            const Token& next() {
+                return this->at(this->head + 1);
+            }
+
+            const Token& peek(size_t count) {
+                return this->at(this->head + count);
+            }
+
+            size_t lookahead() {
+                return this->tokens.size();
+            }
+
+            bool done() {
+                return tokens_isend(this->current().type);
+            }
+
+            bool expect(TokenType type) {
+                return this->current().type == type;
+            }
+
+            void update() {
+                this->head++;
+            }
+
+            Diagnostics& diagnostics() {
+                return this->reports;
+            }
+
+            vixen::sources::SourceRef source_ref() {
+                return this->source;
+            }
+
+            const vixen::numerics::NumericValue* numeric() {
+                return this->numerics.find(std::min(this->head, this->tokens.size() - 1));
+            }
+    };
+
+    // Tree parsing throughput over long chains
+    // of operators and deeply nested groups.
+    void bench_parser_deep() {
+        auto source = vixen::sources::source_from_string(corpus::setup_deep_expressions(4 << 20));
+        auto stream = std::make_shared<const TokenStream>(source);
+        volatile size_t sink = 0;
+
+        std::vector<Token> tokens;
+        for (size_t i = 0; i < stream->size(); i++)
+            tokens.push_back(stream->token(i));
+
+        bench::measure("parse (deep expressions)", source->view().length(), 5, [&]() {
+            TreeParser p(stream);
+            sink = parse(p).arena.nodes();
+        });
+        bench::measure("parse (deep expressions, tokens made)", source->view().length(), 5, [&]() {
+            TokenSpanParser p(tokens, source);
+            sink = parse(p).arena.nodes();
+        });
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdio>
+#include <fstream>
+
+#include "benches/bench.hpp"
+#include "benches/vixen/corpus.hpp"
+#include "include/vixen/sources.hpp"
+#include "include/vixen/tokens.hpp"
+
+namespace bench_vixen::sources {
+    using namespace vixen::sources;
+
+    // Time from a file on disk to a lexer ready
+    // to scan it, and then through a whole lex.
+    void bench_source_open() {
+        std::string corpus    = corpus::setup_corpus(64 << 20);
+        std::string file_name = "/tmp/vixen_bench_corpus.vxn";
+        {
+            std::ofstream file(file_name);
+            file << corpus;
+        }
+
+        bench::measure("source_from_stream (open)", corpus.length(), 5, [&]() {
+            std::ifstream file(file_name);
+            vixen::tokens::Lexer l(file, file_name);
+        });
+        bench::measure("source_open (open)", corpus.length(), 5, [&]() {
+            vixen::tokens::Lexer l(source_open(file_name));
+        });
+        bench::measure("source_open (open + lex)", corpus.length(), 5, [&]() {
+            vixen::tokens::Lexer l(source_open(file_name));
+            while (!l.end()) l.next();
+        });
+
+        bench::measure("StreamLexer (open + lex)", corpus.length(), 5, [&]() {
+            int fd = open(file_name.c_str(), O_RDONLY);
+            vixen::tokens::StreamLexer l(fd, file_name);
+            while (!l.end()) l.next();
+            close(fd);
+        });
+
+        std::remove(file_name.c_str());
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "benches/bench.hpp"
+#include "benches/vixen/corpus.hpp"
+#include "include/vixen/symbols.hpp"
+
+namespace bench_vixen::symbols {
+    using namespace vixen::symbols;
+
+    // Raw symbol parsing throughput over the
+    // whole corpus.
+    void bench_parser_throughput() {
+        std::string corpus = corpus::setup_corpus();
+
+        bench::measure("RawParser::next", corpus.length(), 5, [&]() {
+            RawParser p(corpus);
+            while (!p.end()) p.next();
+        });
+    }
+
+    // Throughput over heavily indented and
+    // commented input, where most of the work is
+    // skipping whitespace and comments.
+    void bench_parser_skipping() {
+        std::string sample;
+        for (int i = 0; i < 8; i++)
+            sample += "        # an indented comment describing code\n";
+        sample += "\n            x = y + z;\n\n";
+
+        std::string corpus;
+        while (corpus.length() < (16 << 20))
+            corpus += sample;
+
+        bench::measure("RawParser::next (commented)", corpus.length(), 5, [&]() {
+            RawParser p(corpus);
+            while (!p.end()) p.next();
+        });
+    }
+
+    // Throughput over long numeric literals,
+    // where each char appended to a numeric must
+    // be checked against the rest of it.
+    void bench_parser_numerics() {
+        std::string sample("x = 1_000_000_000_000_000_000_000_000 + 0x_dead_beef_dead_beef * 3.141_592_653_589_793;\n");
+
+        std::string corpus;
+        while (corpus.length() < (16 << 20))
+            corpus += sample;
+
+        bench::measure("RawParser::next (numerics)", corpus.length(), 5, [&]() {
+            RawParser p(corpus);
+            while (!p.end()) p.next();
+        });
+    }
+
+    // Throughput over long string literals,
+    // where most of the work is finding where
+    // each literal closes.
+    void bench_parser_strings() {
+        std::string text;
+        for (int i = 0; i < 32; i++)
+            text += "a long line of text with an \\\"escaped\\\" quote. ";
+        std::string sample("x = \"" + text + "\" + \"\"\"" + text + "\n" + text + "\"\"\";\n");
+
+        std::string corpus;
+        while (corpus.length() < (16 << 20))
+            corpus += sample;
+
+        bench::measure("RawParser::next (strings)", corpus.length(), 5, [&]() {
+            RawParser p(corpus);
+            while (!p.end()) p.next();
+        });
+    }
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include "benches/bench.hpp"
+#include "benches/vixen/corpus.hpp"
+#include "include/vixen/tokens.hpp"
+
+namespace bench_vixen::tokens {
+    using namespace vixen::tokens;
+
+    // Lexer throughput over the whole corpus,
+    // including token classification.
+    void bench_lexer_throughput() {
+        std::string corpus = corpus::setup_corpus();
+
+        bench::measure("Lexer::next", corpus.length(), 5, [&]() {
+            Lexer l(corpus);
+            while (!l.end()) l.next();
+        });
+    }
+
+    // Classifying every symbol in the corpus as
+    // a keyword, operator or punctuation.
+    void bench_find_gentype() {
+        std::string corpus = corpus::setup_corpus();
+        std::vector<SymbolView> symbols;
+        vixen::symbols::RawParser p(corpus);
+        while (!p.end())
+            symbols.push_back(std::get<2>(p.next_view()));
+
+        // Kept so the lookups are not optimized
+        // away.
+        volatile size_t sink = 0;
+        bench::measure("tokens_find_gentype", corpus.length(), 5, [&]() {
+            size_t found = 0;
+            for (auto const& symbol : symbols)
+                found += (uint)tokens_find_gentype(symbol);
+            sink = found;
+        });
+    }
+
+    // Scanning the types of a whole file's
+    // tokens, held as `Token`s and as a
+    // `TokenStream`.
+    void bench_token_stream() {
+        auto source = vixen::sources::source_from_string(corpus::setup_corpus());
+        size_t length = source->view().length();
+        std::vector<Token> tokens = tokenize_all(source).tokens;
+        TokenStream stream(source);
+
+        std::cout
+            << "  " << tokens.size() << " tokens: "
+            << tokens.size() * sizeof(Token) << " bytes as Token, "
+            << stream.bytes() << " bytes as TokenStream"
+            << std::endl;
+
+        // Kept so the scans are not optimized
+        // away.
+        volatile size_t sink = 0;
+        bench::measure("std::vector<Token> scan", length, 5, [&]() {
+            size_t names = 0;
+            for (auto const& token : tokens)
+                names += token.type == TokenType::NameGeneric;
+            sink = names;
+        });
+        bench::measure("TokenStream scan", length, 5, [&]() {
+            size_t names = 0;
+            for (auto cursor = stream.cursor(); !cursor.done(); cursor.advance())
+                names += cursor.type() == TokenType::NameGeneric;
+            sink = names;
+        });
+    }
+
+    // Lexing with the generated automaton,
+    // compared to `lexer_throughput`.
+    void bench_lexer_dfa() {
+        auto source = vixen::sources::source_from_string(corpus::setup_corpus());
+        size_t length = source->view().length();
+
+        bench::measure("Lexer::next (symbols)", length, 5, [&]() {
+            Lexer l(source, LexerKind::Symbols);
+            while (!l.end()) l.next();
+        });
+        bench::measure("Lexer::next (dfa)", length, 5, [&]() {
+            Lexer l(source, LexerKind::Dfa);
+            while (!l.end()) l.next();
+        });
+    }
+
+    // Lexing a batch of tokens at a time into
+    // a reused buffer, and a whole input at once.
+    void bench_lexer_batch() {
+        std::string corpus = corpus::setup_corpus();
+
+        bench::measure("Lexer::next_batch", corpus.length(), 5, [&]() {
+            Lexer l(corpus);
+            Token buffer[TOKEN_BATCH_SIZE];
+            while (l.next_batch(buffer) == TOKEN_BATCH_SIZE);
+        });
+        bench::measure("Lexer::tokenize_all", corpus.length(), 5, [&]() {
+            Lexer(corpus).tokenize_all();
+        });
+    }
+
+    // Lexing a whole input across every core,
+    // compared to `tokenize_all` on one.
+    void bench_lexer_parallel() {
+        auto source = vixen::sources::source_from_string(corpus::setup_corpus(64 << 20));
+        size_t length = source->view().length();
+
+        bench::measure("tokenize_all", length, 3, [&]() {
+            tokenize_all(source);
+        });
+        bench::measure("tokenize_parallel", length, 3, [&]() {
+            tokenize_parallel(source);
+        });
+    }
+
+    // Drain a lexer through its dynamic
+    // interface. Kept out of line so every call
+    // is dispatched through the vtable.
+    __attribute__((noinline))
+    void drain_dynamic(vixen::symbols::SymbolParser<Token>& l) {
+        while (!l.end()) l.next();
+    }
+
+    // Cost of dispatching the lexer dynamically
+    // compared to `lexer_throughput`.
+    void bench_lexer_dispatch() {
+        std::string corpus = corpus::setup_corpus();
+
+        bench::measure("Lexer::next (static)", corpus.length(), 5, [&]() {
+            Lexer l(corpus);
+            while (!l.end()) l.next();
+        });
+        bench::measure("Lexer::next (dynamic)", corpus.length(), 5, [&]() {
+            vixen::symbols::DynamicSymbolParser<Lexer> l{Lexer(corpus)};
+            drain_dynamic(l);
+        });
+    }
+}
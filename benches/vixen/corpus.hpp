@@ -0,0 +1,71 @@
+#pragma once
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace bench_vixen::corpus {
+    // Sources concatenated to build our benchmark
+    // input. These are the closest thing we have
+    // to 'real' Vixen code.
+    const std::string corpus_files[] = {
+        "examples/test_parser.vxn",
+        "grammar/arithmetic.vxn",
+        "grammar/control.vxn",
+        "grammar/variables.vxn",
+    };
+
+    // Build a large input by repeating the
+    // example sources until at least `min_bytes`
+    // have been produced.
+    std::string setup_corpus(size_t min_bytes = 16 << 20) {
+        std::string sample, corpus;
+
+        for (auto const& file_name : corpus_files) {
+            std::ifstream file(file_name);
+            std::stringstream buf;
+            buf << file.rdbuf();
+            sample.append(buf.str());
+        }
+
+        if (!sample.length())
+            return corpus;
+
+        corpus.reserve(min_bytes + sample.length());
+        while (corpus.length() < min_bytes)
+            corpus.append(sample);
+        return corpus;
+    }
+
+    // Build a large input of arithmetic
+    // statements, the subset of the language our
+    // tree parser can handle.
+    std::string setup_expressions(size_t min_bytes = 1 << 20) {
+        const std::string sample(
+            "x + y * (z - 1);\n"
+            "alpha // 2 + beta % 3 - gamma ** 4;\n"
+            "(1 + 2) * (3 + (4 - x)) / y;\n");
+
+        std::string corpus;
+        corpus.reserve(min_bytes + sample.length());
+        while (corpus.length() < min_bytes)
+            corpus.append(sample);
+        return corpus;
+    }
+
+    // Build a large input of long, deeply nested
+    // arithmetic statements, in the style of
+    // 'grammar/arithmetic.vxn'.
+    std::string setup_deep_expressions(size_t min_bytes = 1 << 20) {
+        const std::string sample(
+            "x + (y * z) ** 3 - a / b // c % d + e * f - g ** h;\n"
+            "((((a + b) * (c - d)) // ((e % f) + (g ** h))) - (((i / j) * k) + l)) * m;\n"
+            "a - b + c - d + e - f + g - h + i - j + k - l + m - n + o - p;\n"
+            "x ** y ** z * (1 + (2 * (3 - (4 / (5 // (6 % (7 + x))))))) + 0.5;\n");
+
+        std::string corpus;
+        corpus.reserve(min_bytes + sample.length());
+        while (corpus.length() < min_bytes)
+            corpus.append(sample);
+        return corpus;
+    }
+}
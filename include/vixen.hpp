@@ -1,5 +1,13 @@
 #pragma once
+#include "vixen/cache.hpp"
+#include "vixen/dfa.hpp"
+#include "vixen/diagnostics.hpp"
+#include "vixen/incremental.hpp"
+#include "vixen/interner.hpp"
+#include "vixen/numerics.hpp"
 #include "vixen/nodes.hpp"
 #include "vixen/parser.hpp"
+#include "vixen/simd.hpp"
+#include "vixen/sources.hpp"
 #include "vixen/symbols.hpp"
 #include "vixen/tokens.hpp"
@@ -0,0 +1,170 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "sources.hpp"
+#include "tokens.hpp"
+
+namespace vixen::cache {
+    using namespace tokens;
+
+    // Bumped whenever the layout of token
+    // caches, or the way sources are lexed,
+    // changes. Caches of any other version are
+    // ignored.
+    #define TOKEN_CACHE_VERSION 2
+    #define TOKEN_CACHE_MAGIC   "VXT"
+
+    // Header of a token cache, a '.vxt' file.
+    //
+    // The header is followed by the arrays of a
+    // `TokenStream`, as is: `count` types, padded
+    // to a multiple of 4 bytes, then `count`
+    // offsets and `count` symbol lengths. Values
+    // are stored in the byte order of the machine
+    // that wrote them.
+    struct CacheHeader {
+        char     magic[4];
+        uint32_t version;
+        // See `cache_hash`.
+        uint64_t hash;
+        // Length of the source, in bytes.
+        uint64_t length;
+        // Number of tokens.
+        uint64_t count;
+        // Number of token types, which changes
+        // with the `TokenType` enumeration.
+        uint32_t type_count;
+        // Byte order marker, always 1.
+        uint32_t order;
+    };
+
+    // Offsets of each array within a cache of
+    // `count` tokens.
+    struct CacheLayout {
+        size_t types;
+        size_t offsets;
+        size_t lengths;
+        size_t end;
+
+        CacheLayout(size_t count) {
+            this->types   = sizeof(CacheHeader);
+            this->offsets = (this->types + count + 3) & ~(size_t)3;
+            this->lengths = this->offsets + count * sizeof(sources::Offset);
+            this->end     = this->lengths + count * sizeof(uint32_t);
+        }
+    };
+
+    // Hash of source text a cache is keyed on.
+    // Reads 8 bytes at a time; not meant to
+    // withstand deliberate collisions.
+    uint64_t cache_hash(std::string_view data) {
+        uint64_t hash = 0x9e3779b97f4a7c15 ^ data.length();
+        size_t   at   = 0;
+
+        while (at < data.length()) {
+            uint64_t word = 0;
+            std::memcpy(&word, data.data() + at, std::min((size_t)8, data.length() - at));
+            hash = (hash ^ word) * 0xff51afd7ed558ccd;
+            hash ^= hash >> 32;
+            at += 8;
+        }
+
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    // Write the tokens of a stream to `path`.
+    // The file is written alongside and moved into
+    // place once complete, so readers never see a
+    // partial cache. Returns false if it could not
+    // be written.
+    bool cache_write(const TokenStream& stream, const std::string& path) {
+        std::string_view data  = stream.source_ref()->view();
+        size_t           count = stream.size();
+        CacheLayout      layout(count);
+
+        CacheHeader header{};
+        std::memcpy(header.magic, TOKEN_CACHE_MAGIC, sizeof(TOKEN_CACHE_MAGIC));
+        header.version    = TOKEN_CACHE_VERSION;
+        header.hash       = cache_hash(data);
+        header.length     = data.length();
+        header.count      = count;
+        header.type_count = TokenTypeCount;
+        header.order      = 1;
+
+        std::string partial = path + ".partial";
+        FILE* file = std::fopen(partial.c_str(), "wb");
+        if (!file)
+            return false;
+
+        const char padding[4] = {};
+        bool written =
+            std::fwrite(&header, sizeof(header), 1, file) == 1
+            && std::fwrite(stream.type_array().data(), 1, count, file) == count
+            && std::fwrite(padding, 1, layout.offsets - layout.types - count, file) == layout.offsets - layout.types - count
+            && std::fwrite(stream.offset_array().data(), sizeof(sources::Offset), count, file) == count
+            && std::fwrite(stream.length_array().data(), sizeof(uint32_t), count, file) == count;
+
+        written = std::fclose(file) == 0 && written;
+        if (!written || std::rename(partial.c_str(), path.c_str()) != 0) {
+            std::remove(partial.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // Load the tokens of `source` from the cache
+    // at `path`. The cache is mapped and its
+    // arrays used in place, nothing is lexed.
+    // Returns `nullptr` if there is no cache, or
+    // it was written for other text, by another
+    // version, or is damaged.
+    std::shared_ptr<TokenStream> cache_load(sources::SourceRef source, const std::string& path) {
+        sources::SourceRef storage = sources::source_open(path, false);
+        if (!storage)
+            return nullptr;
+
+        std::string_view bytes = storage->view();
+        std::string_view data  = source->view();
+        if (bytes.length() < sizeof(CacheHeader))
+            return nullptr;
+
+        CacheHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (std::memcmp(header.magic, TOKEN_CACHE_MAGIC, sizeof(TOKEN_CACHE_MAGIC)) != 0
+            || header.version != TOKEN_CACHE_VERSION
+            || header.type_count != TokenTypeCount
+            || header.order != 1
+            || header.length != data.length()
+            || header.count == 0
+            || header.count > bytes.length())
+            return nullptr;
+
+        CacheLayout layout(header.count);
+        if (layout.end != bytes.length() || header.hash != cache_hash(data))
+            return nullptr;
+
+        // Mapped files, and buffers read into
+        // strings, are aligned well enough for
+        // every array.
+        const char* base = bytes.data();
+        std::span<const uint8_t> types((const uint8_t*)(base + layout.types), header.count);
+        std::span<const sources::Offset> offsets((const sources::Offset*)(base + layout.offsets), header.count);
+        std::span<const uint32_t> lengths((const uint32_t*)(base + layout.lengths), header.count);
+
+        // Every token must lie within the source.
+        for (size_t i = 0; i < header.count; i++) {
+            if (types[i] >= TokenTypeCount || (uint64_t)offsets[i] + lengths[i] > data.length())
+                return nullptr;
+        }
+
+        return std::make_shared<TokenStream>(source, storage, types, offsets, lengths);
+    }
+}
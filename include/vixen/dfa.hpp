@@ -0,0 +1,146 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace vixen::dfa {
+    // State of an automaton. State 0 is dead;
+    // no transitions lead out of it.
+    typedef uint8_t  State;
+    // Value a state accepts with.
+    typedef uint16_t Accept;
+
+    #define DFA_MAX_STATES  256
+    #define DFA_MAX_CLASSES 96
+    // Accepted by states that do not accept.
+    #define DFA_REJECT ((vixen::dfa::Accept)-1)
+
+    constexpr State DEAD  = 0;
+    constexpr State START = 1;
+
+    // A fixed spelling an automaton accepts, and
+    // the value it accepts it with.
+    struct Spelling {
+        std::string_view text;
+        Accept accept;
+    };
+
+    // A deterministic finite automaton over bytes,
+    // built at compile time.
+    //
+    // Bytes the automaton never tells apart share
+    // a class, so the transition table only needs
+    // a column per class rather than per byte.
+    // Classes must all be distinguished before
+    // any transition is added.
+    class Automaton {
+        private:
+            std::array<uint8_t, 256> classes{};
+            std::array<std::array<State, DFA_MAX_CLASSES>, DFA_MAX_STATES> next{};
+            std::array<Accept, DFA_MAX_STATES> accepts{};
+            // States made for some spelling, rather
+            // than shared between many inputs.
+            std::array<bool, DFA_MAX_STATES> owned{};
+            size_t class_count = 1;
+            size_t state_count = 2;
+
+        public:
+            constexpr Automaton() {
+                this->accepts[DEAD]  = DFA_REJECT;
+                this->accepts[START] = DFA_REJECT;
+            }
+
+            // Give `bytes` classes of their own,
+            // apart from every other byte.
+            constexpr void distinguish(std::string_view bytes) {
+                std::array<int16_t, DFA_MAX_CLASSES> split{};
+                std::array<uint16_t, DFA_MAX_CLASSES> size{};
+                std::array<uint16_t, DFA_MAX_CLASSES> inside{};
+                std::array<bool, 256> member{};
+                for (auto& to : split)
+                    to = -1;
+                for (const char& ch : bytes)
+                    member[(uint8_t)ch] = true;
+                for (size_t b = 0; b < 256; b++) {
+                    size[this->classes[b]]++;
+                    inside[this->classes[b]] += member[b];
+                }
+
+                for (size_t b = 0; b < 256; b++) {
+                    uint8_t from = this->classes[b];
+                    // Classes wholly within `bytes` are
+                    // already apart from the rest.
+                    if (!member[b] || inside[from] == size[from])
+                        continue;
+                    if (split[from] < 0) {
+                        if (this->class_count >= DFA_MAX_CLASSES)
+                            throw "too many byte classes";
+                        split[from] = this->class_count++;
+                    }
+                    this->classes[b] = split[from];
+                }
+            }
+
+            // Give every byte in `bytes` a class of
+            // its own.
+            constexpr void distinguish_each(std::string_view bytes) {
+                for (size_t i = 0; i < bytes.length(); i++)
+                    this->distinguish(bytes.substr(i, 1));
+            }
+
+            constexpr State state(Accept accept = DFA_REJECT) {
+                if (this->state_count >= DFA_MAX_STATES)
+                    throw "too many states";
+                this->accepts[this->state_count] = accept;
+                return this->state_count++;
+            }
+
+            // Transition from `from` to `to` on
+            // every byte in `bytes`.
+            constexpr void link(State from, std::string_view bytes, State to) {
+                for (const char& ch : bytes)
+                    this->next[from][this->classes[(uint8_t)ch]] = to;
+            }
+
+            // Accept `spelling`. States the spelling
+            // passes through that are shared, such as
+            // those for names, are copied first so
+            // other inputs are unaffected.
+            constexpr void add(const Spelling& spelling) {
+                State at = START;
+                for (const char& ch : spelling.text) {
+                    uint8_t cls = this->classes[(uint8_t)ch];
+                    State   to  = this->next[at][cls];
+                    if (!this->owned[to]) {
+                        State copy = this->state(to ? this->accepts[to] : DFA_REJECT);
+                        if (to)
+                            this->next[copy] = this->next[to];
+                        this->owned[copy]    = true;
+                        this->next[at][cls]  = copy;
+                        to = copy;
+                    }
+                    at = to;
+                }
+                this->accepts[at] = spelling.accept;
+            }
+
+            // State reached from `from` by `spelling`.
+            constexpr State walk(std::string_view spelling, State from = START) const {
+                for (const char& ch : spelling)
+                    from = this->step(from, ch);
+                return from;
+            }
+
+            constexpr Accept accept(State state) const {
+                return this->accepts[state];
+            }
+
+            constexpr State step(State state, const char ch) const {
+                return this->next[state][this->classes[(uint8_t)ch]];
+            }
+
+            constexpr size_t states() const {
+                return this->state_count;
+            }
+    };
+}
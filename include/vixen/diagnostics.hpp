@@ -0,0 +1,88 @@
+#pragma once
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "tokens.hpp"
+
+namespace vixen::diagnostics {
+    using namespace tokens;
+
+    // An error found in some input, and the
+    // token it was found at.
+    struct Diagnostic {
+        Token       token;
+        std::string message;
+
+        // Write as 'file:lineno:column: error:
+        // message', the file left out if the token
+        // has none. Columns are written from 1.
+        // `source` is the token's, looked up by
+        // the caller.
+        void write(std::ostream& os, const sources::SourceRef& source) const {
+            auto const [lineno, column] = this->token.location(source);
+
+            // Locations count columns from the
+            // newline before them, so only those
+            // on the first line start from 0.
+            if (source && source->name.length() > 0)
+                os << source->name << ":";
+            os << lineno << ":" << (lineno > 1 ? column : column + 1) << ": error: " << this->message;
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const Diagnostic& diagnostic) {
+            diagnostic.write(os, diagnostic.token.source());
+            return os;
+        }
+    };
+
+    // Collects every error found in a pass over
+    // some input, in the order they were found,
+    // rather than stopping at the first.
+    class Diagnostics {
+        private:
+            std::vector<Diagnostic> entries;
+
+        public:
+            void report(const Token& token, std::string message) {
+                this->entries.push_back(Diagnostic{token, std::move(message)});
+            }
+
+            bool empty() const {
+                return this->entries.empty();
+            }
+
+            size_t size() const {
+                return this->entries.size();
+            }
+
+            const Diagnostic& operator[](size_t index) const {
+                return this->entries[index];
+            }
+
+            auto begin() const {
+                return this->entries.begin();
+            }
+
+            auto end() const {
+                return this->entries.end();
+            }
+
+        private:
+            // Sources are looked up once per run of
+            // diagnostics from the same file.
+            friend std::ostream& operator<<(std::ostream& os, const Diagnostics& diagnostics) {
+                sources::SourceRef source;
+                sources::FileId    file_id = 0;
+                for (const Diagnostic& diagnostic : diagnostics) {
+                    if (!source || diagnostic.token.file_id != file_id) {
+                        file_id = diagnostic.token.file_id;
+                        source  = diagnostic.token.source();
+                    }
+                    diagnostic.write(os, source);
+                    os << std::endl;
+                }
+                return os;
+            }
+    };
+}
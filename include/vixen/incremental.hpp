@@ -0,0 +1,639 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "diagnostics.hpp"
+#include "nodes.hpp"
+#include "parser.hpp"
+#include "simd.hpp"
+#include "sources.hpp"
+#include "tokens.hpp"
+
+namespace vixen::incremental {
+    using namespace parser;
+    using diagnostics::Diagnostic;
+
+    // A change to some text: the bytes in
+    // [begin, end) are replaced with `text`.
+    struct TextEdit {
+        sources::Offset  begin = 0;
+        sources::Offset  end   = 0;
+        std::string_view text;
+    };
+
+    // What an edit cost.
+    struct EditStats {
+        // Bytes lexed again, from the start of the
+        // first statement parsed to the end of
+        // the last.
+        size_t relexed = 0;
+        // Statements parsed again.
+        size_t reparsed = 0;
+        // Statements kept from before the edit.
+        size_t reused = 0;
+    };
+
+    // A top level statement of a program, and
+    // the text it owns: from its first token up
+    // to the first token of the statement after
+    // it. The first statement parsed from some
+    // point also owns any text before its first
+    // token, its `lead`.
+    //
+    // Text is never moved once lexed, so its
+    // tokens are left as they were made for as
+    // long as it is kept.
+    struct Statement {
+        std::string_view text;
+        // Offset of the text in the document's
+        // store, which is what tokens hold.
+        sources::Offset  base = 0;
+        sources::Offset  lead = 0;
+        // Offset of the text in the document, and
+        // the newlines before it. Counted back
+        // from the end of the document for those
+        // `after` the last edit.
+        sources::Offset  begin = 0;
+        uint32_t         line  = 0;
+        bool             after = false;
+        // Column the text starts at. Statements
+        // are only kept when their line is, so
+        // this never changes.
+        uint32_t         column = 0;
+        // Follows a terminator, outside of a
+        // string, so where it begins and how it
+        // is lexed do not depend on any text
+        // around it. Statements after an error
+        // may instead begin wherever the error
+        // was recovered from.
+        bool      anchored = false;
+        // Text left with no statement in it has
+        // no node.
+        TreeNode* node  = nullptr;
+        // Nodes made for this statement.
+        size_t    nodes = 0;
+        std::vector<Diagnostic> diagnostics;
+
+        // Built on first use, as for sources.
+        mutable sources::LineIndex lines;
+        mutable std::once_flag     lines_built;
+
+        // Line within the text and column of an
+        // offset into it. Errors may be reported
+        // at the first token of the next
+        // statement, just past the end of the
+        // text; the block it was lexed from still
+        // holds the text after it.
+        sources::Location locate(sources::Offset at) const {
+            std::call_once(this->lines_built, [this]() {
+                this->lines.append(this->text.data(), this->text.data() + this->text.length());
+            });
+
+            sources::Offset within = std::min<sources::Offset>(at, this->text.length());
+            auto [lineno, column]  = this->lines.locate(within);
+            if (lineno == 1)
+                column = this->column + within;
+
+            const char*    text = this->text.data();
+            simd::SkipSpan span = simd::span_lines(text + within, text + at);
+            if (span.newlines)
+                return {lineno + span.newlines, at - (span.last_newline - text)};
+            return {lineno, column + (at - within)};
+        }
+    };
+
+    typedef std::unique_ptr<Statement> StatementRef;
+
+    // Text of a document being edited.
+    //
+    // Text is kept in an append only store, a
+    // block for each stretch of text lexed, and
+    // the document is the text of its statements
+    // in order. Tokens hold offsets into the
+    // store, which are located by finding the
+    // statement they lie in.
+    //
+    // The text is not held in one buffer, so
+    // `view` is empty; see `IncrementalTree::text`.
+    class IncrementalSource : public sources::Source {
+        private:
+            // Text the document was opened with,
+            // kept rather than copied.
+            sources::SourceRef origin;
+            std::vector<std::unique_ptr<char[]>> blocks;
+            sources::Offset next   = 0;
+            size_t          stored = 0;
+
+        public:
+            // Live statements by the offset of their
+            // text in the store.
+            std::map<sources::Offset, const Statement*> statements;
+            // Bytes and newlines in the document.
+            sources::Offset size     = 0;
+            uint32_t        newlines = 0;
+
+        public:
+            IncrementalSource(sources::SourceRef origin) : sources::Source(origin->name) {
+                this->origin = origin;
+                this->next   = origin->view().length() + 1;
+                this->stored = origin->view().length();
+            }
+
+            // The text the document was opened with,
+            // at offset 0 in the store.
+            std::string_view opened() const {
+                return this->origin ? this->origin->view() : std::string_view();
+            }
+
+            // Bytes held by the store, live or not.
+            size_t bytes() const {
+                return this->stored;
+            }
+
+            // Add a block of `length` bytes to the
+            // store. Returns the block and its offset
+            // in the store.
+            std::pair<char*, sources::Offset> allocate(size_t length) {
+                char* block = new char[length + 1];
+                sources::Offset base = this->next;
+                this->blocks.emplace_back(block);
+                this->next   += length + 1;
+                this->stored += length;
+                return {block, base};
+            }
+
+            // Let go of every block.
+            void clear() {
+                this->origin = nullptr;
+                this->blocks.clear();
+                this->statements.clear();
+                this->next   = 0;
+                this->stored = 0;
+            }
+
+            // Position of a statement in the
+            // document.
+            sources::Offset offset(const Statement& statement) const {
+                return statement.after ? this->size - statement.begin : statement.begin;
+            }
+
+            // Only the statement an offset lies in
+            // is indexed.
+            sources::Location locate(sources::Offset offset) const override {
+                auto found = this->statements.upper_bound(offset);
+                if (found == this->statements.begin())
+                    return {1, offset};
+
+                const Statement& statement = *(--found)->second;
+                uint32_t line = statement.after ? this->newlines - statement.line : statement.line;
+                auto [lineno, column] = statement.locate(offset - statement.base);
+                return {line + lineno, column};
+            }
+    };
+
+    // A statement an edit may stop at: the first
+    // token of the statement `kept` from the top
+    // of those after the edit now lies at `at`.
+    struct EditStop {
+        int64_t at   = 0;
+        size_t  kept = 0;
+    };
+
+    // A parsed program that is kept up to date
+    // as its text is edited, for editors and
+    // the REPL.
+    //
+    // An edit relexes and reparses only from the
+    // statement holding the byte before it, up
+    // to the first statement on a later line
+    // than the edit ends on that still begins
+    // where it did, after a terminator and
+    // outside of a string. Every other statement
+    // keeps its subtree untouched.
+    //
+    // Statements are held in a gap buffer, split
+    // at the last edit: those before it count
+    // their position from the start of the
+    // document, those after it from the end. An
+    // edit moves the gap over the statements
+    // between it and the last edit, then only
+    // touches text and statements around itself.
+    //
+    // The tree is brought up to date on the first
+    // call to `tree` after an edit, which links
+    // in every statement and its errors.
+    //
+    // Text and nodes replaced by an edit are kept
+    // until there is more than twice as much as
+    // is live, at which point the whole program
+    // is parsed again.
+    class IncrementalTree {
+        private:
+            std::shared_ptr<IncrementalSource> source;
+            mutable Tree                       parsed;
+            // Statements before the gap in order,
+            // and after it in reverse order.
+            std::vector<StatementRef> front;
+            std::vector<StatementRef> back;
+            // Count of nodes in use, including the
+            // program node.
+            size_t live  = 0;
+            // Statements that have a node.
+            size_t count = 0;
+            // Statements of the program node. Kept
+            // here rather than in the arena, which
+            // would hold a new copy after every edit.
+            mutable std::vector<TreeNode*> body;
+            mutable bool                   stale = true;
+
+            // Move the gap back over one statement.
+            void retreat() {
+                StatementRef statement = std::move(this->front.back());
+                this->front.pop_back();
+                statement->begin = this->source->size - statement->begin;
+                statement->line  = this->source->newlines - statement->line;
+                statement->after = true;
+                this->back.push_back(std::move(statement));
+            }
+
+            // Move the gap forward over one
+            // statement.
+            void advance() {
+                StatementRef statement = std::move(this->back.back());
+                this->back.pop_back();
+                statement->begin = this->source->size - statement->begin;
+                statement->line  = this->source->newlines - statement->line;
+                statement->after = false;
+                this->front.push_back(std::move(statement));
+            }
+
+            // The `k`th statement after the gap.
+            Statement& behind(size_t k) const {
+                return *this->back[this->back.size() - 1 - k];
+            }
+
+            void add(StatementRef statement) {
+                this->source->statements[statement->base] = statement.get();
+                this->live  += statement->nodes;
+                this->count += statement->node != nullptr;
+                this->front.push_back(std::move(statement));
+            }
+
+            void remove(StatementRef& statement) {
+                this->source->statements.erase(statement->base);
+                this->live  -= statement->nodes;
+                this->count -= statement->node != nullptr;
+                statement    = nullptr;
+            }
+
+            // Copy the text of [begin, end) to `out`,
+            // from the statements after `first`
+            // before the gap onwards.
+            char* copy(char* out, size_t first, sources::Offset begin, sources::Offset end) const {
+                size_t ahead = this->front.size() - first;
+                for (size_t k = 0; begin < end; k++) {
+                    const Statement& statement = k < ahead ? *this->front[first + k] : this->behind(k - ahead);
+                    sources::Offset  at        = this->source->offset(statement);
+                    sources::Offset  until     = at + statement.text.length();
+                    if (until <= begin)
+                        continue;
+                    sources::Offset length = std::min(until, end) - begin;
+                    std::memcpy(out, statement.text.data() + (begin - at), length);
+                    out   += length;
+                    begin += length;
+                }
+                return out;
+            }
+
+            // Parse the statements of `text`, which
+            // lies at `base` in the store and at
+            // `from` in the document, on line
+            // `lineno`. Parses to the end of `text`,
+            // or until the first token of a
+            // statement lies at one of `stops`.
+            // Statements are made with `begin` the
+            // offset of their first token into
+            // `text`. Returns the stop reached, or
+            // `stops.size()`.
+            size_t parse_from(
+                std::string_view text,
+                sources::Offset base,
+                sources::Offset from,
+                uint32_t lineno,
+                std::span<const EditStop> stops,
+                std::vector<StatementRef>& made) {
+
+                Lexer lexer(this->source, text, base, lineno);
+                TreeParser parser(std::move(lexer));
+                size_t stop = 0;
+
+                // The parser lexes ahead of itself, so
+                // a second lexer follows along to tell
+                // whether a statement starts within a
+                // string. Symbols are only scanned, not
+                // made into tokens.
+                Lexer follow(this->source, text, base, lineno);
+
+                while (!parser.done()) {
+                    sources::Offset local = parser.current().offset - base;
+                    int64_t         at    = from + local;
+                    while (stop < stops.size() && stops[stop].at < at)
+                        stop++;
+                    while (1) {
+                        follow.advancew();
+                        follow.advancec();
+                        if (follow.end() || follow.position() >= local)
+                            break;
+                        follow.next_view();
+                    }
+
+                    // Tokens after a terminator, outside
+                    // of a string, are lexed the same
+                    // wherever they start, so from here on
+                    // the old statements hold. `text`
+                    // itself starts at such a point.
+                    bool anchored = made.empty() || (parser.previous().type == TokenType::PuncTerminator && !follow.string_mode());
+                    if (!made.empty() && stop < stops.size() && stops[stop].at == at && anchored)
+                        return stop;
+
+                    StatementRef statement = std::make_unique<Statement>();
+                    size_t errors = parser.diagnostics().size();
+                    size_t nodes  = this->parsed.arena.nodes();
+
+                    statement->begin    = local;
+                    statement->anchored = anchored;
+                    statement->node  = parse_toplevel(parser, this->parsed.arena);
+                    statement->nodes = this->parsed.arena.nodes() - nodes;
+                    for (size_t i = errors; i < parser.diagnostics().size(); i++)
+                        statement->diagnostics.push_back(parser.diagnostics()[i]);
+                    made.push_back(std::move(statement));
+                }
+
+                return stops.size();
+            }
+
+            // Give statements made by `parse_from`
+            // the text they own, up to `end` for the
+            // last of them, and their positions.
+            // `column` is where `text` starts on its
+            // line. Text with no statement in it is
+            // given one without a node. Returns the
+            // newlines in the text owned.
+            uint32_t place(
+                std::vector<StatementRef>& made,
+                std::string_view text,
+                sources::Offset base,
+                sources::Offset from,
+                uint32_t line,
+                uint32_t column,
+                sources::Offset end) const {
+
+                if (made.empty()) {
+                    made.push_back(std::make_unique<Statement>());
+                    made.back()->anchored = true;
+                }
+
+                uint32_t        newlines = 0;
+                sources::Offset scanned  = 0;
+                for (size_t i = 0; i < made.size(); i++) {
+                    Statement&      statement = *made[i];
+                    sources::Offset first     = statement.begin;
+                    sources::Offset begin     = i ? first : 0;
+                    sources::Offset until     = i + 1 < made.size() ? made[i + 1]->begin : end;
+
+                    simd::SkipSpan span = simd::span_lines(text.data() + scanned, text.data() + begin);
+                    newlines += span.newlines;
+                    column    = span.newlines ? begin - (span.last_newline - text.data()) : column + (begin - scanned);
+                    scanned   = begin;
+
+                    statement.text   = text.substr(begin, until - begin);
+                    statement.base   = base + begin;
+                    statement.lead   = first - begin;
+                    statement.begin  = from + begin;
+                    statement.line   = line + newlines;
+                    statement.column = column;
+                }
+                return newlines + simd::span_lines(text.data() + scanned, text.data() + end).newlines;
+            }
+
+            // Parse the whole text from scratch.
+            void reparse(std::string_view text, sources::Offset base) {
+                this->parsed = Tree();
+                this->parsed.source = this->source;
+                this->parsed.root   = this->parsed.arena.make(NodeType::Program);
+                this->live  = 1;
+                this->count = 0;
+                this->stale = true;
+
+                std::vector<StatementRef> made;
+                this->parse_from(text, base, 0, 1, {}, made);
+                this->source->size  = text.length();
+                this->source->newlines = this->place(made, text, base, 0, 0, 0, text.length());
+                for (StatementRef& statement : made)
+                    this->add(std::move(statement));
+            }
+
+            // Parse the text again into a fresh
+            // store and arena.
+            void reparse() {
+                std::string text = this->text();
+                this->front.clear();
+                this->back.clear();
+                this->source->clear();
+
+                auto [block, base] = this->source->allocate(text.length());
+                std::memcpy(block, text.data(), text.length());
+                this->reparse(std::string_view(block, text.length()), base);
+            }
+
+            // Point the tree at the current list of
+            // statements.
+            void relink() const {
+                if (!this->stale || !this->parsed.root)
+                    return;
+
+                this->body.clear();
+                this->parsed.diagnostics = Diagnostics();
+                auto link = [this](const Statement& statement) {
+                    if (statement.node)
+                        this->body.push_back(statement.node);
+                    for (const Diagnostic& diagnostic : statement.diagnostics)
+                        this->parsed.diagnostics.report(diagnostic.token, diagnostic.message);
+                };
+                for (const StatementRef& statement : this->front)
+                    link(*statement);
+                for (size_t k = 0; k < this->back.size(); k++)
+                    link(this->behind(k));
+                this->parsed.root->body_set(this->body);
+                this->stale = false;
+            }
+
+        public:
+            IncrementalTree() {}
+            IncrementalTree(sources::SourceRef source) {
+                this->source = std::make_shared<IncrementalSource>(source);
+                this->reparse(this->source->opened(), 0);
+            }
+
+            // Apply an edit to the text and bring the
+            // tree up to date with it. Edits outside
+            // of the text throw `std::out_of_range`
+            // and leave the tree as it was.
+            EditStats edit(const TextEdit& edit) {
+                EditStats       stats;
+                sources::Offset size = this->source->size;
+                if (edit.begin > edit.end || edit.end > size)
+                    throw std::out_of_range("edit outside of the text");
+                int64_t delta = (int64_t)edit.text.length() - (edit.end - edit.begin);
+
+                // The statement holding the byte before
+                // the edit is parsed again, in case its
+                // last token runs into the edit, from the
+                // nearest terminator before it.
+                sources::Offset before = edit.begin ? edit.begin - 1 : 0;
+                while (this->front.size() > 1 && this->front.back()->begin > before)
+                    this->retreat();
+                while (!this->back.empty() && this->source->offset(this->behind(0)) <= before)
+                    this->advance();
+                size_t first = this->front.size() - 1;
+                while (first && !this->front[first]->anchored)
+                    first--;
+                const Statement& start = *this->front[first];
+                sources::Offset  from  = start.begin;
+
+                // Statements are only kept from the line
+                // after the edit on, so their lines and
+                // columns can be worked out from their
+                // own text.
+                sources::Offset kept_from = size + 1;
+                for (size_t k = 0; k <= this->back.size(); k++) {
+                    const Statement& statement = k ? this->behind(k - 1) : *this->front.back();
+                    sources::Offset  at        = this->source->offset(statement);
+                    if (at + statement.text.length() <= edit.end)
+                        continue;
+                    sources::Offset skip  = std::max(at, edit.end) - at;
+                    const void*     found = std::memchr(statement.text.data() + skip, '\n', statement.text.length() - skip);
+                    if (found) {
+                        kept_from = at + ((const char*)found - statement.text.data()) + 1;
+                        break;
+                    }
+                }
+
+                // Lex up to the first statement that may
+                // be kept. Should it not be kept, lex
+                // twice as many statements again.
+                size_t reach = 0;
+                while (reach < this->back.size() && this->source->offset(this->behind(reach)) < kept_from)
+                    reach++;
+                reach = std::min(reach + 1, this->back.size());
+
+                std::vector<StatementRef> made;
+                std::vector<EditStop>     stops;
+                std::string_view          text;
+                sources::Offset           base;
+                size_t                    stop;
+                while (1) {
+                    // Of the last statement lexed, only the
+                    // start of its first token is needed to
+                    // stop at it.
+                    sources::Offset end = size;
+                    if (reach < this->back.size()) {
+                        const Statement& last = this->behind(reach - 1);
+                        end = this->source->offset(last) + std::min<sources::Offset>(last.lead + 1, last.text.length());
+                    }
+                    stops.clear();
+                    for (size_t k = 0; k < reach; k++) {
+                        const Statement& statement = this->behind(k);
+                        sources::Offset  at        = this->source->offset(statement);
+                        if (at >= kept_from && statement.anchored && statement.node)
+                            stops.push_back(EditStop{at + statement.lead + delta, k});
+                    }
+
+                    size_t length = (edit.begin - from) + edit.text.length() + (end - edit.end);
+                    auto [block, offset] = this->source->allocate(length);
+                    char* out = this->copy(block, first, from, edit.begin);
+                    std::memcpy(out, edit.text.data(), edit.text.length());
+                    this->copy(out + edit.text.length(), first, edit.end, end);
+                    text = std::string_view(block, length);
+                    base = offset;
+
+                    // Nodes of a parse cut short stay in
+                    // the arena until the next reparse.
+                    made.clear();
+                    stop = this->parse_from(text, base, from, start.line + 1, stops, made);
+                    if (stop < stops.size() || end == size)
+                        break;
+                    reach = std::min(2 * reach + 1, this->back.size());
+                }
+
+                // Statements from the one parsed from up
+                // to the stop reached are replaced.
+                size_t          kept  = stop < stops.size() ? stops[stop].kept : this->back.size();
+                sources::Offset owned = kept < this->back.size() ? this->source->offset(this->behind(kept)) + delta - from : text.length();
+                uint32_t        lines = this->place(made, text, base, from, start.line, start.column, owned);
+                uint32_t        tail  = kept < this->back.size() ? this->behind(kept).line : 0;
+                lines += start.line;
+
+                stats.reparsed = made.size();
+                stats.reused   = first + (this->back.size() - kept);
+                stats.relexed  = owned;
+
+                for (size_t i = first; i < this->front.size(); i++)
+                    this->remove(this->front[i]);
+                this->front.resize(first);
+                for (size_t k = 0; k < kept; k++)
+                    this->remove(this->back[this->back.size() - 1 - k]);
+                this->back.resize(this->back.size() - kept);
+
+                this->source->size += delta;
+                this->source->newlines = lines + tail;
+                for (StatementRef& statement : made)
+                    this->add(std::move(statement));
+                this->stale = true;
+
+                if (this->parsed.arena.nodes() > 2 * this->live || this->source->bytes() > 2 * (size_t)this->source->size)
+                    this->reparse();
+                return stats;
+            }
+
+            const Tree& tree() const {
+                this->relink();
+                return this->parsed;
+            }
+
+            sources::SourceRef source_ref() const {
+                return this->source;
+            }
+
+            // The text of the program, gathered from
+            // its statements.
+            std::string text() const {
+                std::string text;
+                if (!this->source)
+                    return text;
+                text.resize(this->source->size);
+                this->copy(text.data(), 0, 0, this->source->size);
+                return text;
+            }
+
+            size_t size() const {
+                return this->count;
+            }
+
+        private:
+            friend std::ostream& operator<<(std::ostream& os, const IncrementalTree& tree) {
+                os << tree.tree();
+                return os;
+            }
+    };
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vixen::interner {
+    // Compact id of an interned symbol. Id 0 is
+    // always the empty symbol.
+    typedef uint32_t SymbolId;
+
+    // Default number of bytes reserved for
+    // interned text at a time.
+    #define INTERNER_BLOCK_SIZE (64 << 10)
+
+    // Maps each distinct symbol to a small
+    // integer id.
+    //
+    // The text of every symbol is copied once
+    // into blocks that never move, so memory
+    // grows with the number of distinct symbols
+    // rather than the number of times they are
+    // used, and symbols compare as ids.
+    //
+    // Safe to share between threads. Lookups of
+    // symbols already interned only take a shared
+    // lock.
+    class Interner {
+        private:
+            // Id of a symbol, and a tag callers may
+            // attach to it when first interned.
+            struct Entry {
+                SymbolId id;
+                uint32_t tag;
+            };
+
+            std::vector<std::unique_ptr<char[]>> blocks;
+            size_t block_used = 0;
+            size_t block_size = 0;
+            std::unordered_map<std::string_view, Entry> index;
+            std::vector<std::string_view> symbols;
+            mutable std::shared_mutex lock;
+
+            // Copy text into the arena.
+            std::string_view store(std::string_view symbol) {
+                if (this->block_used + symbol.length() > this->block_size) {
+                    this->block_size = std::max(symbol.length(), (size_t)INTERNER_BLOCK_SIZE);
+                    this->block_used = 0;
+                    this->blocks.emplace_back(new char[this->block_size]);
+                }
+
+                char* at = this->blocks.back().get() + this->block_used;
+                std::memcpy(at, symbol.data(), symbol.length());
+                this->block_used += symbol.length();
+                return std::string_view(at, symbol.length());
+            }
+
+        public:
+            Interner() {
+                this->index.emplace(std::string_view(), Entry{0, 0});
+                this->symbols.emplace_back();
+            }
+
+            // Do not allow copies; views are handed
+            // out against this interner's blocks.
+            Interner(const Interner&) = delete;
+            Interner& operator=(const Interner&) = delete;
+
+            // Get the id of a symbol, interning it
+            // if it has not been seen before.
+            SymbolId intern(std::string_view symbol) {
+                return this->intern_tagged(symbol, [](std::string_view) { return 0u; }).first;
+            }
+
+            // Get the id and tag of a symbol. If it
+            // has not been seen before, it is
+            // interned and tagged with
+            // `tag_of(symbol)`. Lets callers cache
+            // anything that depends only on a
+            // symbol's text, without a second
+            // lookup.
+            template <typename F>
+            std::pair<SymbolId, uint32_t> intern_tagged(std::string_view symbol, F tag_of) {
+                {
+                    std::shared_lock<std::shared_mutex> reading(this->lock);
+                    auto found = this->index.find(symbol);
+                    if (found != this->index.end())
+                        return {found->second.id, found->second.tag};
+                }
+
+                uint32_t tag = tag_of(symbol);
+                std::unique_lock<std::shared_mutex> writing(this->lock);
+                auto found = this->index.find(symbol);
+                if (found != this->index.end())
+                    return {found->second.id, found->second.tag};
+
+                SymbolId id = this->symbols.size();
+                std::string_view stored = this->store(symbol);
+                this->symbols.push_back(stored);
+                this->index.emplace(stored, Entry{id, tag});
+                return {id, tag};
+            }
+
+            // Text of an interned symbol. Views are
+            // valid for as long as the interner is.
+            std::string_view lookup(SymbolId id) const {
+                std::shared_lock<std::shared_mutex> reading(this->lock);
+                if (id >= this->symbols.size())
+                    return std::string_view();
+                return this->symbols[id];
+            }
+
+            // Number of distinct symbols interned,
+            // including the empty symbol.
+            size_t size() const {
+                std::shared_lock<std::shared_mutex> reading(this->lock);
+                return this->symbols.size();
+            }
+    };
+
+    // Interner shared by every lexer in this
+    // process.
+    Interner& interner_global() {
+        static Interner interner;
+        return interner;
+    }
+}
@@ -1,155 +1,672 @@
 #pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
 #include <vector>
 
+#include "diagnostics.hpp"
 #include "tokens.hpp"
 
 namespace vixen::nodes {
     using namespace tokens;
 
+    // Kind of a tree node. Binary and unary
+    // nodes are further told apart by their
+    // operation's token type.
+    enum class NodeType : uint8_t {
+        Program,
+        Binary,
+        Unary,
+        LiteralName,
+        LiteralFlt,
+        LiteralInt,
+        LiteralStr,
+        Terminator,
+        // Input that could not be parsed. See
+        // `Tree::diagnostics` for why.
+        Error
+    };
+
+    constexpr std::string_view NodeNames[] = {
+        "Program",
+        "Binary",
+        "Unary",
+        "LiteralName",
+        "LiteralFlt",
+        "LiteralInt",
+        "LiteralStr",
+        "Terminator",
+        "Error"
+    };
+
+    static_assert(std::size(NodeNames) == (size_t)NodeType::Error + 1, "every NodeType needs a name");
+
+    constexpr bool node_isliteral(NodeType type) {
+        return type >= NodeType::LiteralName && type <= NodeType::LiteralStr;
+    }
+
+    // Nodes printed as the token they hold.
+    constexpr bool node_isleaf(NodeType type) {
+        return node_isliteral(type) || type == NodeType::Error;
+    }
+
+    // Nodes named after their operation.
+    constexpr bool node_isoperation(NodeType type) {
+        return type == NodeType::Binary || type == NodeType::Unary;
+    }
+
+    // Child slots of a tree node.
+    enum class NodeSlot : uint8_t {
+        Value,
+        Left,
+        Right
+    };
+
+    /*
+    Tree node typology.
+    1. Statements
+        i. Expressions
+            - Binary; involves a left, right and an operator.
+            - Unary; involves a value and a prefix operator.
+        ii. Literals
+            - Identity
+            - Float
+            - Integer
+            - String
+    2. Errors; stand in for input that could not be parsed.
+    */
+
+    #define NDATTR_BODY  "__body_idx"
+    #define NDATTR_VALUE "__value__"
+    #define NDATTR_LEFT  NDATTR_VALUE"left"
+    #define NDATTR_RIGHT NDATTR_VALUE"right"
+
+    // Names slots are printed under.
+    constexpr std::string_view NodeSlotNames[] = {
+        NDATTR_VALUE,
+        NDATTR_LEFT,
+        NDATTR_RIGHT
+    };
+
     // A parsed expression, term, or phrase
     // parsed from a sequence of tokens or a
     // value from a single token.
+    //
+    // Nodes live in a `NodeArena` and refer to
+    // their children by pointer, so building a
+    // node never copies a subtree. Programs keep
+    // their statements as one contiguous list,
+    // also within the arena.
     class TreeNode {
         private:
-            std::unordered_map<std::string, TreeNode> children;
-            Token       token;
-            std::string type;
+            Token     token;
+            NodeType  type = NodeType::Program;
+            TreeNode* slots[3] = {};
+            TreeNode* const* body = nullptr;
+            uint32_t  body_count = 0;
+            // Decoded value of a numeric literal,
+            // kept in the node's arena.
+            const numerics::NumericValue* value = nullptr;
 
         public:
             TreeNode() {}
-            TreeNode(std::string type) {
+            TreeNode(NodeType type) {
                 this->type = type;
             }
-            TreeNode(std::string type, Token token) {
+            TreeNode(NodeType type, Token token) {
                 this->token = token;
                 this->type  = type;
             }
 
+            // Name of this node's kind. Binary and
+            // unary nodes are named after their
+            // operation.
+            std::string_view name() const {
+                if (node_isoperation(this->type))
+                    return tokens_find_genname(this->token.type);
+                return NodeNames[(size_t)this->type];
+            }
+
+            NodeType node_type() const {
+                return this->type;
+            }
+
             // Number of child nodes.
-            uint child_count() {
-                return this->children.size();
+            uint child_count() const {
+                uint count = this->body_count;
+                for (TreeNode* const& child : this->slots)
+                    count += child != nullptr;
+                return count;
+            }
+
+            // Get a child node by slot, or `nullptr`
+            // if the slot is empty.
+            TreeNode* child_get(NodeSlot slot) const {
+                return this->slots[(size_t)slot];
+            }
+
+            // Assign a child node to a slot.
+            void child_set(NodeSlot slot, TreeNode* node) {
+                this->slots[(size_t)slot] = node;
             }
 
-            // Get a child node from this node
-            // by name.
-            TreeNode child_get(std::string name) {
-                return this->children[name];
+            // Statements of a program, in order.
+            std::span<TreeNode* const> body_get() const {
+                return std::span<TreeNode* const>(this->body, this->body_count);
             }
 
-            // Assign a child node by name.
-            void child_set(std::string name, TreeNode node) {
-                this->children[name] = node;
+            // Assign the statements of a program.
+            // The list must outlive this node, see
+            // `NodeArena::make_list`.
+            void body_set(std::span<TreeNode* const> body) {
+                this->body       = body.data();
+                this->body_count = body.size();
+            }
+
+            Token token_get() const {
+                return this->token;
+            }
+
+            void token_set(Token token) {
+                this->token = token;
+            }
+
+            // Decoded value of a numeric literal,
+            // or `nullptr` if this node is not one.
+            const numerics::NumericValue* numeric() const {
+                return this->value;
+            }
+
+            // Assign the value of a numeric literal.
+            // The value must outlive this node, see
+            // `NodeArena::make_numeric`.
+            void numeric_set(const numerics::NumericValue* value) {
+                this->value = value;
+            }
+
+            // Interned id of this node's symbol,
+            // or 0 if it has none.
+            interner::SymbolId symbol_id() const {
+                return this->token.id;
             }
         private:
-            friend std::ostream& operator<<(std::ostream& os, const TreeNode& node) {
-                os << node.type << "Node";
-                if (node.type.find("Literal") != std::string::npos) {
-                    os << "[value: " << node.token << "]";
-                    return os;
-                }
+            // Nodes are walked with a stack of their
+            // own, as in `flat_from_tree`, so the
+            // longest chains the parser builds print
+            // without overflowing the call stack.
+            friend std::ostream& operator<<(std::ostream& os, const TreeNode& root) {
+                // A node to print, after its label, or
+                // the end of a node's children if it is
+                // `nullptr`.
+                struct Pending {
+                    const TreeNode*  node;
+                    std::string_view label;
+                    size_t           index;
+                    bool             after;
+                };
 
-                if (node.token.symbol != "") {
-                    os << "(" << node.token.symbol << ")";
-                }
+                std::vector<Pending> pending = {{&root, "", SIZE_MAX, false}};
+                std::vector<Pending> children;
+                while (!pending.empty()) {
+                    auto const [node, label, index, after] = pending.back();
+                    pending.pop_back();
 
-                os << "[";
-                for (auto it = node.children.begin(); it != node.children.end();) {
-                    auto current = it++;
-                    os << current->first << ": " << current->second;
-                    if (it != node.children.end())
+                    if (!node) {
+                        os << "]";
+                        continue;
+                    }
+                    if (after)
                         os << ", ";
+                    if (!label.empty()) {
+                        os << label;
+                        if (index != SIZE_MAX)
+                            os << index;
+                        os << ": ";
+                    }
+
+                    os << node->name() << "Node";
+                    if (node_isleaf(node->type)) {
+                        os << "[value: " << node->token << "]";
+                        continue;
+                    }
+
+                    if (node->token.symbol != "") {
+                        os << "(" << node->token.symbol << ")";
+                    }
+
+                    os << "[";
+                    children.clear();
+                    for (size_t i = 0; i < node->body_count; i++)
+                        children.push_back({node->body[i], NDATTR_BODY, i, !children.empty()});
+                    for (size_t i = 0; i < std::size(node->slots); i++) {
+                        if (node->slots[i])
+                            children.push_back({node->slots[i], NodeSlotNames[i], SIZE_MAX, !children.empty()});
+                    }
+
+                    // Children are pushed last to first, so
+                    // they are printed first to last.
+                    pending.push_back({nullptr, "", SIZE_MAX, false});
+                    pending.insert(pending.end(), children.rbegin(), children.rend());
                 }
-                os << "]";
 
                 return os;
             }
     };
 
-    /*
-    Tree node typology.
-    1. Statements
-        i. Expressions
-            - Binary; involves a left, right and an operator.
-        ii. Literals
-            - Identity
-            - Float
-            - Integer
-            - String
-    */
+    // Nodes, and values kept for them, are
+    // never destroyed one at a time, only
+    // released along with their arena.
+    static_assert(std::is_trivially_destructible_v<TreeNode>);
+    static_assert(std::is_trivially_destructible_v<numerics::NumericValue>);
 
-    #define NDATTR_BODY  "__body_idx"
-    #define NDATTR_VALUE "__value__"
-    #define NDATTR_LEFT  NDATTR_VALUE"left"
-    #define NDATTR_RIGHT NDATTR_VALUE"right"
+    // Default number of bytes reserved for nodes
+    // at a time.
+    #define NODE_ARENA_BLOCK_SIZE (64 << 10)
 
-    // Adds a node to this program body.
-    void node_program_add(TreeNode& program, TreeNode& node) {
-        std::string name = NDATTR_BODY + std::to_string(program.child_count());
-        program.child_set(name, node);
+    // Allocates the nodes of a tree, and lists of
+    // nodes, from large blocks by bumping an
+    // offset. Everything allocated is freed at
+    // once, along with the arena.
+    class NodeArena {
+        private:
+            std::vector<std::unique_ptr<std::byte[]>> blocks;
+            size_t block_used  = 0;
+            size_t block_size  = 0;
+            size_t block_total = 0;
+            size_t node_count  = 0;
+
+            void* allocate(size_t size, size_t align) {
+                size_t at = (this->block_used + align - 1) & ~(align - 1);
+                if (this->blocks.empty() || at + size > this->block_size) {
+                    // Lists larger than a block get a
+                    // block of their own.
+                    this->block_size   = std::max(size, (size_t)NODE_ARENA_BLOCK_SIZE);
+                    this->block_total += this->block_size;
+                    this->blocks.emplace_back(new std::byte[this->block_size]);
+                    at = 0;
+                }
+
+                this->block_used = at + size;
+                return this->blocks.back().get() + at;
+            }
+
+        public:
+            NodeArena() {}
+
+            // Nodes point into the arena's blocks,
+            // which move along with it but are
+            // never copied.
+            NodeArena(const NodeArena&) = delete;
+            NodeArena& operator=(const NodeArena&) = delete;
+            NodeArena(NodeArena&&) = default;
+            NodeArena& operator=(NodeArena&&) = default;
+
+            template <typename... Args>
+            TreeNode* make(Args&&... args) {
+                this->node_count++;
+                return new (this->allocate(sizeof(TreeNode), alignof(TreeNode))) TreeNode(std::forward<Args>(args)...);
+            }
+
+            // Copy a list of nodes into the arena.
+            std::span<TreeNode* const> make_list(std::span<TreeNode* const> nodes) {
+                if (nodes.empty())
+                    return {};
+
+                auto list = (TreeNode**)this->allocate(nodes.size_bytes(), alignof(TreeNode*));
+                std::copy(nodes.begin(), nodes.end(), list);
+                return std::span<TreeNode* const>(list, nodes.size());
+            }
+
+            // Copy a decoded value into the arena,
+            // or `nullptr` if there is none.
+            const numerics::NumericValue* make_numeric(const numerics::NumericValue* value) {
+                if (!value)
+                    return nullptr;
+                return new (this->allocate(sizeof(numerics::NumericValue), alignof(numerics::NumericValue))) numerics::NumericValue(*value);
+            }
+
+            // Number of nodes made.
+            size_t nodes() const {
+                return this->node_count;
+            }
+
+            // Bytes reserved for nodes and lists.
+            size_t bytes() const {
+                return this->block_total;
+            }
+    };
+
+    // A parsed tree, along with the arena its
+    // nodes live in and every error found while
+    // parsing it.
+    //
+    // Token symbols are views into the source
+    // they were lexed from, so the tree holds on
+    // to it; see `TokenList`.
+    class Tree {
+        public:
+            sources::SourceRef source;
+            NodeArena arena;
+            TreeNode* root = nullptr;
+            diagnostics::Diagnostics diagnostics;
+
+        private:
+            friend std::ostream& operator<<(std::ostream& os, const Tree& tree) {
+                if (tree.root)
+                    os << *tree.root;
+                return os;
+            }
+    };
+
+    // Set the statements of this program body.
+    void node_program_set(NodeArena& arena, TreeNode* program, std::span<TreeNode* const> body) {
+        program->body_set(arena.make_list(body));
     }
 
-    // Get the ref of a program node.
-    TreeNode node_program_get(TreeNode& program, uint idx) {
-        std::string name = NDATTR_BODY + std::to_string(idx);
-        return program.child_get(name);
+    // Get a statement of a program node.
+    TreeNode* node_program_get(const TreeNode* program, uint idx) {
+        auto body = program->body_get();
+        return idx < body.size() ? body[idx] : nullptr;
     }
 
     // Get the left value node from a statement.
-    TreeNode node_stmt_getleft(TreeNode& stmt) {
-        return stmt.child_get(NDATTR_LEFT);
+    TreeNode* node_stmt_getleft(const TreeNode* stmt) {
+        return stmt->child_get(NodeSlot::Left);
     }
 
     // Get the right value node from a statement.
-    TreeNode node_stmt_getright(TreeNode& stmt) {
-        return stmt.child_get(NDATTR_RIGHT);
+    TreeNode* node_stmt_getright(const TreeNode* stmt) {
+        return stmt->child_get(NodeSlot::Right);
     }
 
     // Get the value node from the statement.
-    TreeNode node_stmt_getvalue(TreeNode& stmt) {
-        return stmt.child_get(NDATTR_VALUE);
+    TreeNode* node_stmt_getvalue(const TreeNode* stmt) {
+        return stmt->child_get(NodeSlot::Value);
     }
 
     // Set the left value node of the statement.
-    void node_stmt_setleft(TreeNode& stmt, TreeNode& left) {
-        stmt.child_set(NDATTR_LEFT, left);
+    void node_stmt_setleft(TreeNode* stmt, TreeNode* left) {
+        stmt->child_set(NodeSlot::Left, left);
     }
 
     // Set the right value node of the statement.
-    void node_stmt_setright(TreeNode& stmt, TreeNode& right) {
-        stmt.child_set(NDATTR_RIGHT, right);
+    void node_stmt_setright(TreeNode* stmt, TreeNode* right) {
+        stmt->child_set(NodeSlot::Right, right);
     }
 
     // Set the value node of a statement.
-    void node_stmt_setvalue(TreeNode& stmt, TreeNode& value) {
-        stmt.child_set(NDATTR_VALUE, value);
+    void node_stmt_setvalue(TreeNode* stmt, TreeNode* value) {
+        stmt->child_set(NodeSlot::Value, value);
     }
 
     // Initialize a node as a binary statement.
-    TreeNode node_init_binary(
+    TreeNode* node_init_binary(
+        NodeArena& arena,
         Token operation,
-        TreeNode& left,
-        TreeNode& right) {
-
-            TreeNode stmt(
-                tokens_find_genname(operation.type),
-                operation
-            );
+        TreeNode* left,
+        TreeNode* right) {
 
+            TreeNode* stmt = arena.make(NodeType::Binary, operation);
             node_stmt_setleft(stmt, left);
             node_stmt_setright(stmt, right);
 
             return stmt;
         }
 
+    // Initialize a node as a unary statement.
+    TreeNode* node_init_unary(NodeArena& arena, Token operation, TreeNode* value) {
+        TreeNode* stmt = arena.make(NodeType::Unary, operation);
+        node_stmt_setvalue(stmt, value);
+
+        return stmt;
+    }
+
     // Initialize a node as a literal value.
-    TreeNode node_init_literal(std::string subtype, Token value)
+    // Numeric literals also take their decoded
+    // value, already within `arena`.
+    TreeNode* node_init_literal(
+        NodeArena& arena,
+        NodeType type,
+        Token value,
+        const numerics::NumericValue* numeric = nullptr)
     {
-        TreeNode stmt("Literal" + subtype, value);
-        return stmt;
+        TreeNode* literal = arena.make(type, value);
+        literal->numeric_set(numeric);
+        return literal;
     }
 
     // Initialize a terminator node.
-    TreeNode node_init_term(Token terminator) {
-        return TreeNode("Terminator", terminator);
+    TreeNode* node_init_term(NodeArena& arena, Token terminator) {
+        return arena.make(NodeType::Terminator, terminator);
+    }
+
+    // Initialize a node standing in for input
+    // that could not be parsed, starting at
+    // `token`.
+    TreeNode* node_init_error(NodeArena& arena, Token token) {
+        return arena.make(NodeType::Error, token);
+    }
+
+    // Index of a node in a `FlatTree`.
+    typedef uint32_t NodeIndex;
+
+    // Marks a missing node, or a node without a
+    // token.
+    #define NODE_NONE ((vixen::nodes::NodeIndex)-1)
+
+    // A node of a `FlatTree`. Plain data, so a
+    // tree copies, compares and stores as one
+    // block of memory.
+    //
+    // Children are linked first-child and
+    // next-sibling, and `slot` records which
+    // slot of the parent each child fills.
+    struct FlatNode {
+        NodeType  kind  = NodeType::Program;
+        NodeSlot  slot  = NodeSlot::Value;
+        // Index of this node's token in the
+        // stream the tree was parsed from.
+        NodeIndex token = NODE_NONE;
+        NodeIndex first_child  = NODE_NONE;
+        NodeIndex next_sibling = NODE_NONE;
+    };
+
+    static_assert(sizeof(FlatNode) == 16);
+    static_assert(std::is_trivially_copyable_v<FlatNode>);
+
+    // A tree laid out as one vector of nodes in
+    // pre-order: every node comes before its
+    // children, and a subtree is a contiguous
+    // range. Visiting every node is a linear
+    // scan, with no pointers to chase.
+    //
+    // Tokens are not copied, nodes index the
+    // `TokenStream` the tree was parsed from.
+    class FlatTree {
+        public:
+            std::vector<FlatNode> nodes;
+            std::shared_ptr<const TokenStream> stream;
+
+            // Name of a node's kind, as with
+            // `TreeNode::name`.
+            std::string_view name(NodeIndex index) const {
+                const FlatNode& node = this->nodes[index];
+                if (node_isoperation(node.kind))
+                    return tokens_find_genname(this->stream->type(node.token));
+                return NodeNames[(size_t)node.kind];
+            }
+
+            // Token of a node, or an empty token if
+            // it has none.
+            Token token(NodeIndex index) const {
+                NodeIndex token = this->nodes[index].token;
+                return token == NODE_NONE ? Token() : this->stream->token(token);
+            }
+
+            // Decoded value of a numeric literal
+            // node, or `nullptr` if it is not one.
+            const numerics::NumericValue* numeric(NodeIndex index) const {
+                NodeIndex token = this->nodes[index].token;
+                return token == NODE_NONE ? nullptr : this->stream->numeric(token);
+            }
+
+            // Child of a node filling `slot`, or
+            // `NODE_NONE`.
+            NodeIndex child_get(NodeIndex index, NodeSlot slot) const {
+                NodeIndex child = this->nodes[index].first_child;
+                while (child != NODE_NONE && this->nodes[child].slot != slot)
+                    child = this->nodes[child].next_sibling;
+                return child;
+            }
+
+            size_t size() const {
+                return this->nodes.size();
+            }
+
+            // Bytes held for nodes. Tokens belong to
+            // the stream.
+            size_t bytes() const {
+                return this->nodes.capacity() * sizeof(FlatNode);
+            }
+
+        private:
+            // Nodes are walked with a stack of their
+            // own, as the arena tree's printer does.
+            void print(std::ostream& os, NodeIndex root) const {
+                // A node to print, after its label, or
+                // the end of a node's children if it is
+                // `NODE_NONE`.
+                struct Pending {
+                    NodeIndex        index;
+                    std::string_view label;
+                    size_t           body;
+                    bool             after;
+                };
+
+                std::vector<Pending> pending = {{root, "", SIZE_MAX, false}};
+                std::vector<Pending> children;
+                while (!pending.empty()) {
+                    auto const [index, label, body, after] = pending.back();
+                    pending.pop_back();
+
+                    if (index == NODE_NONE) {
+                        os << "]";
+                        continue;
+                    }
+                    if (after)
+                        os << ", ";
+                    if (!label.empty()) {
+                        os << label;
+                        if (body != SIZE_MAX)
+                            os << body;
+                        os << ": ";
+                    }
+
+                    const FlatNode& node = this->nodes[index];
+                    Token token = this->token(index);
+
+                    os << this->name(index) << "Node";
+                    if (node_isleaf(node.kind)) {
+                        os << "[value: " << token << "]";
+                        continue;
+                    }
+
+                    if (token.symbol != "") {
+                        os << "(" << token.symbol << ")";
+                    }
+
+                    os << "[";
+                    children.clear();
+                    for (NodeIndex child = node.first_child; child != NODE_NONE; child = this->nodes[child].next_sibling) {
+                        if (node.kind == NodeType::Program)
+                            children.push_back({child, NDATTR_BODY, children.size(), !children.empty()});
+                        else
+                            children.push_back({child, NodeSlotNames[(size_t)this->nodes[child].slot], SIZE_MAX, !children.empty()});
+                    }
+
+                    pending.push_back({NODE_NONE, "", SIZE_MAX, false});
+                    pending.insert(pending.end(), children.rbegin(), children.rend());
+                }
+            }
+
+            friend std::ostream& operator<<(std::ostream& os, const FlatTree& tree) {
+                if (tree.size())
+                    tree.print(os, 0);
+                return os;
+            }
+    };
+
+    // Index of `token` within `stream`, or
+    // `NODE_NONE` if it was not lexed there.
+    NodeIndex flat_token(const TokenStream& stream, const Token& token) {
+        auto offsets = stream.offset_array();
+        auto found   = std::lower_bound(offsets.begin(), offsets.end(), token.offset);
+        size_t index = found - offsets.begin();
+        if (found == offsets.end() || *found != token.offset || stream.type(index) != token.type)
+            return NODE_NONE;
+        return index;
+    }
+
+    // Lay out a tree of `TreeNode`s, parsed from
+    // `stream`, as a `FlatTree`. Prints the same
+    // as the tree it was built from.
+    //
+    // Nodes are walked with a stack of their own
+    // rather than by recursion, so the longest
+    // chains the parser builds cannot overflow
+    // the call stack.
+    FlatTree flat_from_tree(const TreeNode* root, std::shared_ptr<const TokenStream> stream) {
+        struct Pending {
+            const TreeNode* node;
+            NodeSlot        slot;
+            NodeIndex       parent;
+        };
+
+        FlatTree tree;
+        tree.stream = stream;
+        if (!root)
+            return tree;
+
+        std::vector<Pending> pending = {{root, NodeSlot::Value, NODE_NONE}};
+        // Last child linked to each node so far.
+        std::vector<NodeIndex> last;
+
+        while (!pending.empty()) {
+            auto const [node, slot, parent] = pending.back();
+            pending.pop_back();
+
+            NodeIndex index = tree.nodes.size();
+            FlatNode  flat;
+            flat.kind = node->node_type();
+            flat.slot = slot;
+            if (flat.kind != NodeType::Program)
+                flat.token = flat_token(*stream, node->token_get());
+            tree.nodes.push_back(flat);
+            last.push_back(NODE_NONE);
+
+            if (parent != NODE_NONE) {
+                if (last[parent] == NODE_NONE)
+                    tree.nodes[parent].first_child = index;
+                else
+                    tree.nodes[last[parent]].next_sibling = index;
+                last[parent] = index;
+            }
+
+            // Children are pushed last to first, so
+            // they are laid out first to last.
+            for (NodeSlot child : {NodeSlot::Right, NodeSlot::Left, NodeSlot::Value}) {
+                if (node->child_get(child))
+                    pending.push_back({node->child_get(child), child, index});
+            }
+            auto body = node->body_get();
+            for (size_t i = body.size(); i > 0; i--)
+                pending.push_back({body[i - 1], NodeSlot::Value, index});
+        }
+
+        return tree;
     }
 };
@@ -0,0 +1,254 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "symbols.hpp"
+
+namespace vixen::numerics {
+    using namespace symbols;
+
+    // Widest integer literal that can be decoded,
+    // enough for `int256` and `uint256`.
+    #define NUMERIC_BITS 256
+    // Floats with no more chars than this, less
+    // separators, are decoded without allocating.
+    #define NUMERIC_FLOAT_BUFFER 64
+
+    // Magnitude of an integer literal, as 32 bit
+    // limbs from the least significant up.
+    class Integer {
+        private:
+            std::array<uint32_t, NUMERIC_BITS / 32> limbs{};
+
+        public:
+            constexpr Integer() {}
+
+            constexpr Integer(uint64_t value) {
+                this->limbs[0] = (uint32_t)value;
+                this->limbs[1] = (uint32_t)(value >> 32);
+            }
+
+            // Multiply by `base` and add `digit`.
+            // Returns false if the result does not
+            // fit, in which case it is truncated.
+            constexpr bool mul_add(uint32_t base, uint32_t digit) {
+                uint64_t carry = digit;
+                for (auto& limb : this->limbs) {
+                    uint64_t wide = (uint64_t)limb * base + carry;
+                    limb  = (uint32_t)wide;
+                    carry = wide >> 32;
+                }
+                return carry == 0;
+            }
+
+            // Number of bits needed to hold the
+            // magnitude; 0 for 0.
+            constexpr size_t bits() const {
+                for (size_t i = this->limbs.size(); i > 0; i--) {
+                    uint32_t limb = this->limbs[i - 1];
+                    if (limb)
+                        return (i - 1) * 32 + (32 - std::countl_zero(limb));
+                }
+                return 0;
+            }
+
+            // Magnitude is exactly a power of 2.
+            constexpr bool ispow2() const {
+                size_t set = 0;
+                for (const uint32_t& limb : this->limbs)
+                    set += std::popcount(limb);
+                return set == 1;
+            }
+
+            // Low 64 bits of the magnitude.
+            constexpr uint64_t low() const {
+                return (uint64_t)this->limbs[1] << 32 | this->limbs[0];
+            }
+
+            constexpr bool operator==(const Integer&) const = default;
+    };
+
+    enum NumericStatus : uint8_t {
+        // Decoded exactly, or to the nearest
+        // float.
+        NUMERIC_OK,
+        // Too large for `NUMERIC_BITS`, or for a
+        // double.
+        NUMERIC_OVERFLOW,
+        // Not a valid literal of its kind, such as
+        // '1x2'.
+        NUMERIC_INVALID
+    };
+
+    // Value of a numeric literal.
+    struct NumericValue {
+        NumericKind   kind     = NUMERIC_INT;
+        NumericStatus status   = NUMERIC_OK;
+        bool          negative = false;
+        // Magnitude, for every kind but floats.
+        Integer       integer;
+        // Value, for floats.
+        double        floating = 0;
+
+        // Value fits in an integer `bits` wide.
+        constexpr bool fits(size_t bits, bool is_signed) const {
+            if (this->status != NUMERIC_OK || this->kind == NUMERIC_FLT)
+                return false;
+
+            size_t used = this->integer.bits();
+            if (!is_signed)
+                return used <= bits && (!this->negative || !used);
+            // The most negative value needs one bit
+            // fewer than its magnitude suggests.
+            if (this->negative && this->integer.ispow2())
+                return used <= bits;
+            return used < bits;
+        }
+
+        // Value as an `int64_t`, if it fits.
+        constexpr int64_t as_int64() const {
+            uint64_t magnitude = this->integer.low();
+            return this->negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+        }
+    };
+
+    // Value of a digit in any base up to 16, or
+    // 16 if `ch` is not a digit.
+    constexpr uint32_t numeric_digit(const char ch) {
+        if (ch >= '0' && ch <= '9')
+            return ch - '0';
+        if (ch >= 'a' && ch <= 'f')
+            return ch - 'a' + 10;
+        if (ch >= 'A' && ch <= 'F')
+            return ch - 'A' + 10;
+        return 16;
+    }
+
+    // Decode an integer literal of some kind.
+    // `symbol` has had any sign removed.
+    constexpr void numeric_decode_integer(SymbolView symbol, NumericValue& value) {
+        uint32_t base = 0;
+        if (symbol.length() > 1 && symbol[0] == '0') {
+            switch (symbol[1]) {
+                case 'b': base = 2;  break;
+                case 'd': base = 10; break;
+                case 'o': base = 8;  break;
+                case 'x': base = 16; break;
+            }
+        }
+        if (base)
+            symbol.remove_prefix(2);
+        else
+            base = 10;
+
+        bool digits = false;
+        for (const char& ch : symbol) {
+            if (ch == '_')
+                continue;
+
+            uint32_t digit = numeric_digit(ch);
+            if (digit >= base) {
+                value.status = NUMERIC_INVALID;
+                return;
+            }
+            if (!value.integer.mul_add(base, digit))
+                value.status = NUMERIC_OVERFLOW;
+            digits = true;
+        }
+
+        if (!digits)
+            value.status = NUMERIC_INVALID;
+    }
+
+    // Decode a float literal. `symbol` has had
+    // any sign removed.
+    void numeric_decode_float(SymbolView symbol, NumericValue& value) {
+        char        buffer[NUMERIC_FLOAT_BUFFER];
+        std::string spilled;
+        char*       at = buffer;
+
+        if (symbol.length() > NUMERIC_FLOAT_BUFFER) {
+            spilled.resize(symbol.length());
+            at = spilled.data();
+        }
+
+        char* end = at;
+        for (const char& ch : symbol) {
+            if (ch != '_')
+                *end++ = ch;
+        }
+
+        auto const [stop, error] = std::from_chars(at, end, value.floating);
+        if (error == std::errc::result_out_of_range)
+            value.status = NUMERIC_OVERFLOW;
+        else if (error != std::errc() || stop != end)
+            value.status = NUMERIC_INVALID;
+    }
+
+    // Decode a numeric literal of a kind found by
+    // `NumericScan`. Integers of up to
+    // `NUMERIC_BITS` are decoded exactly.
+    NumericValue numeric_decode(SymbolView symbol, NumericKind kind) {
+        NumericValue value;
+        value.kind = kind;
+
+        if (!symbol.empty() && symbol[0] == '-') {
+            value.negative = true;
+            symbol.remove_prefix(1);
+        }
+
+        if (kind == NUMERIC_FLT)
+            numeric_decode_float(symbol, value);
+        else
+            numeric_decode_integer(symbol, value);
+        if (value.kind == NUMERIC_FLT && value.negative)
+            value.floating = -value.floating;
+        return value;
+    }
+
+    NumericValue numeric_decode(SymbolView symbol) {
+        return numeric_decode(symbol, NumericScan(symbol).kind());
+    }
+
+    // Decoded values of the numeric tokens in a
+    // sequence of tokens, addressed by each
+    // token's index in the sequence.
+    class NumericTable {
+        private:
+            // Indices are added in order, so they
+            // are always sorted.
+            std::vector<uint32_t>     indices;
+            std::vector<NumericValue> values;
+
+        public:
+            void add(uint32_t index, const NumericValue& value) {
+                this->indices.push_back(index);
+                this->values.push_back(value);
+            }
+
+            // Value of the token at `index`, or
+            // `nullptr` if it is not numeric.
+            const NumericValue* find(uint32_t index) const {
+                auto found = std::lower_bound(this->indices.begin(), this->indices.end(), index);
+                if (found == this->indices.end() || *found != index)
+                    return nullptr;
+                return &this->values[found - this->indices.begin()];
+            }
+
+            size_t size() const {
+                return this->values.size();
+            }
+
+            // Bytes held for values.
+            size_t bytes() const {
+                return this->indices.capacity() * sizeof(uint32_t)
+                    + this->values.capacity() * sizeof(NumericValue);
+            }
+    };
+}
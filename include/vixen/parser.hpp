@@ -1,99 +1,615 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
 #include "nodes.hpp"
 #include "tokens.hpp"
 
 namespace vixen::parser {
     using namespace nodes;
     using namespace tokens;
+    using diagnostics::Diagnostics;
+
+    // Anything the parsing functions below can
+    // build a tree from.
+    //
+    // The parsing functions are templates over
+    // this concept, so token access is resolved
+    // at compile time and inlined into them.
+    template <typename P>
+    concept TokenParsing = requires(P& parser, TokenType type, size_t count) {
+        // The current token being observed.
+        { parser.current() } -> std::convertible_to<Token>;
+        // The last token observed.
+        { parser.previous() } -> std::convertible_to<Token>;
+        // The next token to be observed.
+        { parser.next() } -> std::convertible_to<Token>;
+        // The token `count` tokens after the
+        // current one, where `count` is at most
+        // `lookahead()`.
+        { parser.peek(count) } -> std::convertible_to<Token>;
+        // How far past the current token `peek`
+        // can see.
+        { parser.lookahead() } -> std::convertible_to<size_t>;
+        // The lexer has been exhausted of all
+        // available tokens.
+        { parser.done() } -> std::convertible_to<bool>;
+        // Validates that the current token is of
+        // the expected type.
+        //
+        // Returns false, and reports an error to
+        // `diagnostics`, if it is not.
+        { parser.expect(type) } -> std::convertible_to<bool>;
+        // Requests the next token from the
+        // lexer and rotates the token history.
+        parser.update();
+        // Errors found so far.
+        { parser.diagnostics() } -> std::same_as<Diagnostics&>;
+        // Source the tokens are views into.
+        { parser.source_ref() } -> std::convertible_to<sources::SourceRef>;
+        // Decoded value of the current token, or
+        // `nullptr` if it is not numeric. Valid
+        // until the parser moves on.
+        { parser.numeric() } -> std::convertible_to<const numerics::NumericValue*>;
+    };
 
+    // Dynamically dispatched parser, for where
+    // the kind of parser is only known at
+    // runtime. See `DynamicParser`.
     class Parser {
-        protected:
-            Lexer lexer;
-
         public:
-            // The current token being observed.
-            virtual Token current() = 0;
-            // The last token observed.
-            virtual Token previous() = 0;
-            // The next token to be observed.
-            virtual Token next() = 0;
-            // The lexer has been exhausted of all
-            // available tokens.
+            virtual ~Parser() {}
+            virtual const Token& current() = 0;
+            virtual const Token& previous() = 0;
+            virtual const Token& next() = 0;
+            virtual const Token& peek(size_t count) = 0;
+            virtual size_t lookahead() = 0;
             virtual bool done() = 0;
-            // Looks ahead for the next available
-            // token, validating if said token if
-            // of the expected type.
-            //
-            // This function returns `void` but
-            // panics if the next token is not of
-            // the expected type.
-            virtual void expect(TokenType type) = 0;
-            // Requests the next token from the
-            // lexer and rotates the token history.
+            virtual bool expect(TokenType type) = 0;
             virtual void update() = 0;
+            virtual Diagnostics& diagnostics() = 0;
+            virtual sources::SourceRef source_ref() = 0;
+            virtual const numerics::NumericValue* numeric() = 0;
     };
 
-    class TreeParser : public Parser {
+    // Adapts a statically dispatched parser to
+    // the `Parser` interface.
+    template <TokenParsing P>
+    class DynamicParser : public Parser {
         private:
-            Token lexer_ribbon[3];
+            P parser;
 
         public:
-            TreeParser() {}
-            TreeParser(Lexer lexer) {
-                this->lexer = lexer;
-                this->update();
-                this->update();
+            DynamicParser(P parser) : parser(std::move(parser)) {}
+
+            const Token& current() {
+                return this->parser.current();
+            }
+
+            const Token& previous() {
+                return this->parser.previous();
             }
 
-            Token current() {
-                return this->lexer_ribbon[1];
+            const Token& next() {
+                return this->parser.next();
             }
 
-            Token previous() {
-                return this->lexer_ribbon[0];
+            const Token& peek(size_t count) {
+                return this->parser.peek(count);
             }
 
-            Token next() {
-                return this->lexer_ribbon[2];
+            size_t lookahead() {
+                return this->parser.lookahead();
             }
 
             bool done() {
-                for (const auto& symbol : {"EOF", "EOL"}) {
-                    if (this->current().symbol == symbol)
-                        return true;
+                return this->parser.done();
+            }
+
+            bool expect(TokenType type) {
+                return this->parser.expect(type);
+            }
+
+            void update() {
+                this->parser.update();
+            }
+
+            Diagnostics& diagnostics() {
+                return this->parser.diagnostics();
+            }
+
+            sources::SourceRef source_ref() {
+                return this->parser.source_ref();
+            }
+
+            const numerics::NumericValue* numeric() {
+                return this->parser.numeric();
+            }
+    };
+
+    // Number of tokens a `TreeParser` can see
+    // past the current one.
+    #define PARSER_LOOKAHEAD 4
+
+    // A position a parser may be rewound to.
+    struct ParserMark {
+        // Position of the token that was current
+        // when the mark was made.
+        size_t position = 0;
+
+        bool operator==(const ParserMark&) const = default;
+    };
+
+    // Parsers that can save where they are and
+    // return there later, for parsing ahead
+    // speculatively.
+    template <typename P>
+    concept TokenRewinding = TokenParsing<P> && requires(P& parser, ParserMark mark) {
+        // Position of the current token. Tokens
+        // from here on are kept until the mark is
+        // released.
+        { parser.mark() } -> std::same_as<ParserMark>;
+        // Make the token at a mark current again.
+        parser.rewind(mark);
+        // Tokens kept for a mark are no longer
+        // needed.
+        parser.release(mark);
+    };
+
+    // Parses tokens from a lexer or a token
+    // stream, seeing up to `Depth` tokens past
+    // the current one.
+    //
+    // Tokens are held in a ring, along with the
+    // one before the current token. Moving on
+    // overwrites the oldest slot in place, and
+    // tokens are handed out by reference, so
+    // looking ahead never copies a token.
+    //
+    // Rewinding refills the ring from tokens
+    // already lexed, so it costs the same
+    // wherever the mark is. While any mark is
+    // held, batches are kept rather than lexed
+    // over.
+    //
+    // Numeric tokens are decoded as they are
+    // lexed, or read from the stream, so no
+    // stage after the parser reads a literal's
+    // text again. See `numeric`.
+    template <size_t Depth>
+    class BasicTreeParser {
+        static_assert(Depth >= 1, "a parser must see at least the next token");
+
+        private:
+            static constexpr size_t RingSize = std::bit_ceil(Depth + 2);
+
+            Lexer lexer;
+            std::array<Token, RingSize> ring;
+            // Position of the current token, counted
+            // from the start of input.
+            size_t ring_head = 0;
+            // Tokens are lexed a batch at a time
+            // and handed out from here.
+            std::vector<Token> batch;
+            size_t batch_head = 0;
+            // Number of tokens pulled before the
+            // first in the batch.
+            size_t batch_base = 0;
+            // Number of marks not yet released.
+            size_t marks = 0;
+            // Values of numeric tokens pulled from
+            // the lexer, decoded once each as they
+            // are first pulled, and addressed by
+            // token index.
+            numerics::NumericTable numerics;
+            size_t decoded = 0;
+            // Tokens already lexed, such as those
+            // loaded from a token cache, are read
+            // from a stream instead.
+            std::shared_ptr<const TokenStream> stream;
+            TokenStream::Cursor stream_cursor;
+            // Once the end of input is reached it
+            // is handed out from then on.
+            Token end;
+            bool  ended = false;
+            // Errors found so far.
+            Diagnostics reports;
+
+            // Next token from the current batch,
+            // lexing another batch if need be.
+            Token pull() {
+                if (this->ended)
+                    return this->end;
+
+                if (this->stream) {
+                    this->end   = this->stream_cursor.token();
+                    this->ended = this->stream_cursor.done();
+                    this->stream_cursor.advance();
+                    return this->end;
                 }
-                return false;
+                if (this->batch_head >= this->batch.size()) {
+                    // Tokens still in the ring are carried
+                    // over into the next batch, so one may
+                    // be marked, and rewound to, after the
+                    // batch it was lexed in has gone.
+                    size_t keep = this->marks ? this->batch.size() : std::min(this->batch.size(), RingSize);
+                    this->batch_base += this->batch.size() - keep;
+                    if (keep < this->batch.size())
+                        std::move(this->batch.end() - keep, this->batch.end(), this->batch.begin());
+
+                    this->batch.resize(keep + TOKEN_BATCH_SIZE);
+                    this->batch.resize(keep + this->lexer.next_batch(std::span<Token>(this->batch).subspan(keep)));
+                    this->batch_head = keep;
+                }
+                this->end   = this->batch[this->batch_head++];
+                this->ended = this->lexer.symbol_isend(this->end.symbol);
+
+                size_t index = this->batch_base + this->batch_head - 1;
+                if (index >= this->decoded) {
+                    if (tokens_isnumeric(this->end.type))
+                        this->numerics.add(index, numerics::numeric_decode(this->end.symbol, tokens_find_numkind(this->end.type)));
+                    this->decoded = index + 1;
+                }
+                return this->end;
+            }
+
+            Token& slot(size_t position) {
+                return this->ring[position & (RingSize - 1)];
             }
 
-            void expect(TokenType type) {
-                std::string got, exp;
-                Token curr;
-                
-                curr = this->current();
-                if (curr.type != type) {
-                    got = tokens_find_genname(curr.symbol);
-                    exp = tokens_find_genname(type);
-                    std::cerr
-                        << "Expected " << exp << " got '" << got << "'."
-                        << std::endl;
-                    exit(1);
+            // Pull the token at `position` next.
+            // Positions past the end of input pull
+            // the end of input. Tokens no longer held
+            // for a mark cannot be pulled again, and
+            // throw `std::out_of_range`.
+            void seek(size_t position) {
+                size_t index = position - 1;
+                this->ended  = false;
+                if (this->stream) {
+                    this->stream_cursor = this->stream->cursor(index);
+                    return;
                 }
+
+                bool lexed = index >= this->batch_base && index - this->batch_base < this->batch.size();
+                if (!lexed && (index < this->batch_base || this->batch.empty() || !this->lexer.symbol_isend(this->batch.back().symbol)))
+                    throw std::out_of_range("seek to a token the parser no longer holds");
+                this->batch_head = std::min(index - this->batch_base, this->batch.size() - 1);
+            }
+
+            // Fill the ring, leaving the first token
+            // current and no previous token.
+            void fill() {
+                this->ring_head = 1;
+                for (size_t i = 0; i <= Depth; i++)
+                    this->slot(this->ring_head + i) = this->pull();
+            }
+
+        public:
+            BasicTreeParser() {}
+            BasicTreeParser(Lexer lexer) {
+                this->lexer = std::move(lexer);
+                this->fill();
+            }
+
+            BasicTreeParser(std::shared_ptr<const TokenStream> stream) {
+                this->stream = stream;
+                this->stream_cursor = stream->cursor();
+                this->fill();
+            }
+
+            const Token& current() {
+                return this->slot(this->ring_head);
+            }
+
+            const Token& previous() {
+                return this->slot(this->ring_head - 1);
+            }
+
+            const Token& next() {
+                return this->slot(this->ring_head + 1);
+            }
+
+            // The token `count` tokens past the
+            // current one, where `count` is at most
+            // `Depth`, or `std::out_of_range` is
+            // thrown. `peek(0)` is the current token.
+            const Token& peek(size_t count) {
+                if (count > Depth)
+                    throw std::out_of_range("peek past the parser's lookahead");
+                return this->slot(this->ring_head + count);
+            }
+
+            static constexpr size_t lookahead() {
+                return Depth;
+            }
+
+            bool done() {
+                TokenType type = this->current().type;
+                return type == TokenType::CTRLCharEOF || type == TokenType::CTRLCharEOL;
+            }
+
+            bool expect(TokenType type) {
+                const Token& curr = this->current();
+                if (curr.type == type)
+                    return true;
+
+                std::string message("Expected ");
+                message.append(tokens_find_genname(type));
+                message.append(" got '");
+                message.append(curr.symbol);
+                message.append("'.");
+                this->reports.report(curr, std::move(message));
+                return false;
+            }
+
+            Diagnostics& diagnostics() {
+                return this->reports;
+            }
+
+            sources::SourceRef source_ref() {
+                return this->stream ? this->stream->source_ref() : this->lexer.source_ref();
+            }
+
+            const numerics::NumericValue* numeric() {
+                size_t index = this->ring_head - 1;
+                return this->stream ? this->stream->numeric(index) : this->numerics.find(index);
             }
 
             void update() {
-                this->lexer_ribbon[0] = this->current();
-                this->lexer_ribbon[1] = this->next();
-                this->lexer_ribbon[2] = this->lexer.next();
+                this->ring_head++;
+                this->slot(this->ring_head + Depth) = this->pull();
+            }
+
+            ParserMark mark() {
+                this->marks++;
+                return ParserMark{this->ring_head};
+            }
+
+            // Make the token at `mark` current. Any
+            // mark not yet released, or any position
+            // reached since the oldest such mark, may
+            // be rewound to.
+            void rewind(ParserMark mark) {
+                if (mark.position == this->ring_head)
+                    return;
+
+                this->ring_head = mark.position;
+                if (mark.position > 1) {
+                    this->seek(mark.position - 1);
+                    this->slot(mark.position - 1) = this->pull();
+                } else {
+                    this->seek(mark.position);
+                    this->slot(mark.position - 1) = Token();
+                }
+                for (size_t i = 0; i <= Depth; i++)
+                    this->slot(mark.position + i) = this->pull();
+            }
+
+            void release(ParserMark) {
+                this->marks--;
             }
     };
 
-    typedef TreeNode(*node_parser)(Parser&);
-    TreeNode parse_expr(Parser&);
+    typedef BasicTreeParser<PARSER_LOOKAHEAD> TreeParser;
+
+    static_assert(TokenParsing<TreeParser>);
+    static_assert(TokenRewinding<TreeParser>);
+    static_assert(TokenParsing<Parser>);
+
+    // Results of rules already parsed at a
+    // position, so parsing ahead speculatively
+    // never repeats work. Rules are told apart by
+    // ids their callers choose.
+    //
+    // Nodes are kept by pointer, and are only
+    // valid for as long as the arena they were
+    // made in.
+    class ParseMemo {
+        public:
+            struct Entry {
+                // Node the rule parsed, or `nullptr`
+                // if it did not match.
+                TreeNode*  node;
+                // Where the parser was left.
+                ParserMark end;
+            };
+
+        private:
+            typedef std::pair<uint32_t, size_t> Key;
+
+            // Mixes the rule into every bit of the
+            // position, so neither is truncated.
+            struct KeyHash {
+                size_t operator()(const Key& key) const {
+                    uint64_t hash = (key.second ^ (uint64_t)key.first << 32 ^ key.first) * 0xff51afd7ed558ccd;
+                    return hash ^ hash >> 32;
+                }
+            };
+
+            std::unordered_map<Key, Entry, KeyHash> entries;
+
+            static Key key(uint32_t rule, ParserMark at) {
+                return Key(rule, at.position);
+            }
+
+        public:
+            const Entry* find(uint32_t rule, ParserMark at) const {
+                auto found = this->entries.find(key(rule, at));
+                return found == this->entries.end() ? nullptr : &found->second;
+            }
+
+            void add(uint32_t rule, ParserMark at, Entry entry) {
+                this->entries[key(rule, at)] = entry;
+            }
+
+            size_t size() const {
+                return this->entries.size();
+            }
+
+            void clear() {
+                this->entries.clear();
+            }
+    };
+
+    // Parse with `rule`, unless it was already
+    // parsed at the current position, in which
+    // case its result is reused and the parser
+    // moved on to where the rule left it.
+    //
+    // Positions reused this way must still be
+    // held by a mark, see `BasicTreeParser`.
+    template <TokenRewinding P, typename F>
+    TreeNode* parse_memoized(P& parser, NodeArena& arena, ParseMemo& memo, uint32_t rule, F parse_rule) {
+        ParserMark at = parser.mark();
+        parser.release(at);
+
+        if (const ParseMemo::Entry* found = memo.find(rule, at)) {
+            parser.rewind(found->end);
+            return found->node;
+        }
+
+        TreeNode*  node = parse_rule(parser, arena);
+        ParserMark end  = parser.mark();
+        parser.release(end);
+
+        memo.add(rule, at, ParseMemo::Entry{node, end});
+        return node;
+    }
+
+    // How tightly an operator binds to the
+    // expressions either side of it. 0 means
+    // the token is not such an operator.
+    //
+    // Left associative operators bind tighter
+    // on their right, so the loop in
+    // `parse_expr_pratt` folds the next operator
+    // of the same power into the left; right
+    // associative operators are the other way
+    // around.
+    struct BindingPower {
+        uint8_t left  = 0;
+        uint8_t right = 0;
+    };
+
+    // Operators in order of increasing
+    // precedence.
+    #define PARSER_POWER_ASSIGN   2
+    #define PARSER_POWER_LGOR     4
+    #define PARSER_POWER_LGAND    6
+    #define PARSER_POWER_BTOR     8
+    #define PARSER_POWER_BTXOR    10
+    #define PARSER_POWER_BTAND    12
+    #define PARSER_POWER_EQUALS   14
+    #define PARSER_POWER_COMPARE  16
+    #define PARSER_POWER_ADD      18
+    #define PARSER_POWER_MULTIPLY 20
+    #define PARSER_POWER_PREFIX   22
+    #define PARSER_POWER_POWER    24
+
+    constexpr BindingPower parser_left(uint8_t power) {
+        return BindingPower{power, (uint8_t)(power + 1)};
+    }
+
+    constexpr BindingPower parser_right(uint8_t power) {
+        return BindingPower{(uint8_t)(power + 1), power};
+    }
+
+    // Binding power of every infix operator,
+    // indexed by token type.
+    constexpr std::array<BindingPower, TokenTypeCount> parser_infix_init() {
+        std::array<BindingPower, TokenTypeCount> powers{};
+        auto set = [&](TokenType type, BindingPower power) {
+            powers[(size_t)type] = power;
+        };
+
+        set(TokenType::OperAssign,   parser_right(PARSER_POWER_ASSIGN));
+        set(TokenType::OperPlusEq,   parser_right(PARSER_POWER_ASSIGN));
+        set(TokenType::OperMinusEq,  parser_right(PARSER_POWER_ASSIGN));
+        set(TokenType::OperLgOr,     parser_left(PARSER_POWER_LGOR));
+        set(TokenType::OperLgAnd,    parser_left(PARSER_POWER_LGAND));
+        set(TokenType::OperBtOr,     parser_left(PARSER_POWER_BTOR));
+        set(TokenType::OperBtXor,    parser_left(PARSER_POWER_BTXOR));
+        set(TokenType::OperBtAnd,    parser_left(PARSER_POWER_BTAND));
+        set(TokenType::OperEquals,   parser_left(PARSER_POWER_EQUALS));
+        set(TokenType::OperLgGt,     parser_left(PARSER_POWER_COMPARE));
+        set(TokenType::OperLgGte,    parser_left(PARSER_POWER_COMPARE));
+        set(TokenType::OperLgLt,     parser_left(PARSER_POWER_COMPARE));
+        set(TokenType::OperLgLte,    parser_left(PARSER_POWER_COMPARE));
+        set(TokenType::OperPlus,     parser_left(PARSER_POWER_ADD));
+        set(TokenType::OperMinus,    parser_left(PARSER_POWER_ADD));
+        set(TokenType::OperDivide,   parser_left(PARSER_POWER_MULTIPLY));
+        set(TokenType::OperDivFloor, parser_left(PARSER_POWER_MULTIPLY));
+        set(TokenType::OperModulus,  parser_left(PARSER_POWER_MULTIPLY));
+        set(TokenType::OperStar,     parser_left(PARSER_POWER_MULTIPLY));
+        set(TokenType::OperPower,    parser_right(PARSER_POWER_POWER));
+        return powers;
+    }
+
+    // Binding power of every prefix operator,
+    // indexed by token type.
+    constexpr std::array<uint8_t, TokenTypeCount> parser_prefix_init() {
+        std::array<uint8_t, TokenTypeCount> powers{};
+        powers[(size_t)TokenType::OperMinus] = PARSER_POWER_PREFIX;
+        powers[(size_t)TokenType::OperPlus]  = PARSER_POWER_PREFIX;
+        powers[(size_t)TokenType::OperLgNot] = PARSER_POWER_PREFIX;
+        return powers;
+    }
+
+    constexpr auto InfixPowers  = parser_infix_init();
+    constexpr auto PrefixPowers = parser_prefix_init();
+
+    static_assert(InfixPowers[(size_t)TokenType::OperStar].left > InfixPowers[(size_t)TokenType::OperPlus].right);
+    static_assert(InfixPowers[(size_t)TokenType::OperPower].right < InfixPowers[(size_t)TokenType::OperPower].left);
+
+    // The current statement declares names,
+    // such as 'x, y: int;', rather than being an
+    // expression. Decided by looking ahead, so
+    // only declarations whose names all fit in
+    // the parser's lookahead are recognized.
+    template <TokenParsing P>
+    bool parse_isdeclaration(P& parser) {
+        for (size_t at = 0; at + 1 <= parser.lookahead(); at += 2) {
+            if (!tokens_isgeneric(parser.peek(at)))
+                return false;
+
+            TokenType after = parser.peek(at + 1).type;
+            if (after == TokenType::PuncColon)
+                return true;
+            if (after != TokenType::PuncComma)
+                return false;
+        }
+        return false;
+    }
+
+    template <TokenParsing P>
+    TreeNode* parse_expr(P&, NodeArena&);
+
+    template <TokenParsing P>
+    TreeNode* parse_expr_pratt(P&, NodeArena&, uint8_t);
 
     // Parse the simplest possible expression
     // nodes.
-    TreeNode parse_expr_primitive(Parser& parser) {
+    template <TokenParsing P>
+    TreeNode* parse_expr_primitive(P& parser, NodeArena& arena) {
         Token current_tk = parser.current();
+
+        // Values are copied out before moving on,
+        // which may decode more.
+        const numerics::NumericValue* value = arena.make_numeric(parser.numeric());
+
+        // A terminator here ends the statement
+        // before its expression is complete. It is
+        // left for the statement to consume, so a
+        // ';' always ends one.
+        if (current_tk.type == TokenType::PuncTerminator) {
+            parser.diagnostics().report(current_tk, "Unexpected token ';'.");
+            return node_init_error(arena, current_tk);
+        }
         parser.update();
 
         // Determines what kind of primitive value
@@ -101,130 +617,186 @@ namespace vixen::parser {
         // ensure if the current token is unknown
         // and treat it like it is a name.
         if (tokens_isgeneric(current_tk))
-            return node_init_literal("Name", current_tk);
+            return node_init_literal(arena, NodeType::LiteralName, current_tk);
 
         // Next is determine the numerical tokens.
         // If token is a float token type, return
         // a float node.
         else if (tokens_isfloat(current_tk))
-            return node_init_literal("Flt", current_tk);
+            return node_init_literal(arena, NodeType::LiteralFlt, current_tk, value);
 
         // If token is a value that can express an
         // integer value, return an integer node.
         else if (tokens_isinteger(current_tk))
-            return node_init_literal("Int", current_tk);
+            return node_init_literal(arena, NodeType::LiteralInt, current_tk, value);
 
         // Parse our groupings next. We treat
         // groupings as an individual phrase which
         // adds weight, in a sense, to the
         // contained expression.
         else if (current_tk.type == TokenType::PuncLParen) {
-            TreeNode expr = parse_expr(parser);
-            parser.expect(TokenType::PuncRParen);
+            // Only the first error of a statement
+            // is reported, one within the grouping
+            // leaves its ')' unchecked.
+            size_t    errors = parser.diagnostics().size();
+            TreeNode* expr   = parse_expr(parser, arena);
+            if (parser.diagnostics().size() != errors)
+                return expr;
+            if (!parser.expect(TokenType::PuncRParen))
+                return node_init_error(arena, parser.current());
             parser.update();
             return expr;
 
         // Parse strings.
         } else if (current_tk.type == TokenType::StrSingleDbl) {
-            TreeNode expr = node_init_literal("Str", parser.current());
+            TreeNode* expr = node_init_literal(arena, NodeType::LiteralStr, parser.current());
 
             // Update the lexer ribbon, validate
             // that the next token is the closing
             // string char and consume that token.
             parser.update();
-            parser.expect(TokenType::StrSingleDbl);
+            if (!parser.expect(TokenType::StrSingleDbl))
+                return node_init_error(arena, parser.current());
             parser.update();
             return expr;
 
-        // If the current token is a terminator,
-        // we continue on to the next statement.
-        } else if (current_tk.type == TokenType::PuncTerminator) {
-            return node_init_term(current_tk);
-
         // If an unsupported token is presented,
-        // throw an error and bail.
+        // report it and stand an error node in
+        // its place.
         } else {
-            std::cerr
-                << "Unexpected token at "
-                << "(lineno: " << current_tk.lineno << " col: "
-                << current_tk.column << "). Got " << current_tk.symbol
-                << std::endl;
-            std::exit(1);
+            std::string message;
+            if (tokens_isend(current_tk.type)) {
+                message = "Unexpected end of input.";
+            } else {
+                message = "Unexpected token '";
+                message.append(current_tk.symbol);
+                message.append("'.");
+            }
+            parser.diagnostics().report(current_tk, std::move(message));
+            return node_init_error(arena, current_tk);
         }
     }
 
-    // Parse a binary expression from the next
-    // series of series of nodes.
-    TreeNode parse_expr_binary(
-        Parser& parser,
-        vector<TokenType> expects,
-        node_parser next) {
+    // Parse an expression, or the operand of a
+    // prefix operator.
+    template <TokenParsing P>
+    TreeNode* parse_expr_prefix(P& parser, NodeArena& arena) {
+        Token   operation = parser.current();
+        uint8_t power     = PrefixPowers[(size_t)operation.type];
+        if (!power)
+            return parse_expr_primitive(parser, arena);
 
-        auto exists = [&](TokenType item){
-            auto exp = expects;
-            return std::find(exp.begin(), exp.end(), item) != exp.end();
-        };
+        parser.update();
+        return node_init_unary(arena, operation, parse_expr_pratt(parser, arena, power));
+    }
 
-        Token    operation;
-        TreeNode left, right;
+    // Parse an expression whose operators all
+    // bind tighter than `min_power`.
+    //
+    // Operators are looked up in `InfixPowers`,
+    // so every level of precedence is handled by
+    // the one loop, rather than a function per
+    // level.
+    template <TokenParsing P>
+    TreeNode* parse_expr_pratt(P& parser, NodeArena& arena, uint8_t min_power) {
+        TreeNode* left = parse_expr_prefix(parser, arena);
+
+        while (true) {
+            Token        operation = parser.current();
+            BindingPower power     = InfixPowers[(size_t)operation.type];
+            if (!power.left || power.left < min_power)
+                break;
 
-        left = next(parser);
-        while (exists(parser.current().type)) {
-            operation = parser.current();
             parser.update();
-            right = next(parser);
-            left  = node_init_binary(operation, left, right);
+            TreeNode* right = parse_expr_pratt(parser, arena, power.right);
+            left = node_init_binary(arena, operation, left, right);
         }
 
         return left;
     }
 
-    // A binary expression which defines a
-    // multiplicative operation.
-    // (*, /, //, ** or %)
-    TreeNode parse_expr_multiplicative(Parser& parser) {
-        return parse_expr_binary(
-            parser,
-            {
-                TokenType::OperDivide,
-                TokenType::OperDivFloor,
-                TokenType::OperModulus,
-                TokenType::OperStar,
-                TokenType::OperPower
-            },
-            parse_expr_primitive);
+    template <TokenParsing P>
+    TreeNode* parse_expr(P& parser, NodeArena& arena) {
+        return parse_expr_pratt(parser, arena, 0);
     }
 
-    TreeNode parse_expr_additive(Parser& parser) {
-        return parse_expr_binary(
-            parser,
-            {
-                TokenType::OperPlus,
-                TokenType::OperMinus
-            },
-            parse_expr_multiplicative);
+    template <TokenParsing P>
+    TreeNode* parse_stmt(P& parser, NodeArena& arena) {
+        // A lone terminator is an empty
+        // statement, and consumes itself.
+        if (parser.current().type == TokenType::PuncTerminator) {
+            Token current_tk = parser.current();
+            parser.update();
+            return node_init_term(arena, current_tk);
+        }
+        return parse_expr(parser, arena);
     }
 
-    TreeNode parse_expr(Parser& parser) {
-        return parse_expr_additive(parser);
+    // Token a statement may resume from after
+    // an error: the start of a keyword
+    // statement, or the end of input.
+    constexpr bool parse_issync(TokenType type) {
+        return (type > TokenType::Kwd && type <= TokenType::KwdWith) || tokens_isend(type);
     }
 
-    TreeNode parse_stmt(Parser& parser) {
-        return parse_expr(parser);
+    // Recover from an error by skipping the
+    // rest of the statement it was found in, up
+    // to and including the next ';' or '}'.
+    template <TokenParsing P>
+    void parse_synchronize(P& parser) {
+        while (!parse_issync(parser.current().type)) {
+            TokenType type = parser.current().type;
+            parser.update();
+            if (type == TokenType::PuncTerminator || type == TokenType::PuncRBrace)
+                return;
+        }
     }
 
-    // Creates an AST from the given parser and
-    // its internal lexer.
-    TreeNode parse(Parser& parser) {
-        TreeNode program("Program");
-        TreeNode next;
-
-        while (!parser.done()) {
-            next = parse_stmt(parser);
-            parser.update();
-            node_program_add(program, next);
+    // Parse one statement of a program, along
+    // with the terminator ending it. If it holds
+    // an error, the rest of it is skipped, see
+    // `parse_synchronize`.
+    template <TokenParsing P>
+    TreeNode* parse_toplevel(P& parser, NodeArena& arena) {
+        size_t    errors = parser.diagnostics().size();
+        TreeNode* stmt   = parse_stmt(parser, arena);
+
+        // Terminators consume themselves, every
+        // other statement ends with one.
+        if (stmt->node_type() != NodeType::Terminator && parser.diagnostics().size() == errors) {
+            if (parser.current().type == TokenType::PuncTerminator)
+                parser.update();
+            else if (!parser.done())
+                parser.expect(TokenType::PuncTerminator);
         }
+        if (parser.diagnostics().size() != errors)
+            parse_synchronize(parser);
+
+        return stmt;
+    }
 
-        return program;
+    // Creates an AST from the given parser and
+    // its internal lexer. Every node of the tree
+    // is allocated from, and freed with, the
+    // tree's arena.
+    //
+    // Errors do not stop parsing. Each is
+    // reported to the tree's diagnostics, stood
+    // in for by an error node, and the rest of
+    // its statement skipped, so every error in
+    // the input is found in one pass.
+    template <TokenParsing P>
+    Tree parse(P& parser) {
+        Tree tree;
+        std::vector<TreeNode*> body;
+
+        tree.source = parser.source_ref();
+        tree.root   = tree.arena.make(NodeType::Program);
+        while (!parser.done())
+            body.push_back(parse_toplevel(parser, tree.arena));
+        node_program_set(tree.arena, tree.root, body);
+        tree.diagnostics = std::move(parser.diagnostics());
+
+        return tree;
     }
 };
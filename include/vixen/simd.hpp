@@ -0,0 +1,263 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace vixen::simd {
+    // Summary of a run of bytes skipped over by
+    // one of the skipping routines below.
+    struct SkipSpan {
+        // First byte that was not skipped.
+        const char* stop;
+        // Number of newlines within the run.
+        uint32_t    newlines;
+        // Last newline within the run, if any.
+        const char* last_newline;
+    };
+
+    // Byte is whitespace. Mirrors the
+    // `char_isnoparse` class in `symbols.hpp`;
+    // ' ' and '\t' through '\r'.
+    constexpr bool byte_isspace(const char ch) {
+        return ch == ' ' || (uint8_t)(ch - '\t') < 5;
+    }
+
+    // Skip over whitespace one byte at a time.
+    // Used where no vector unit is available and
+    // to finish off the tail of a vectorized run.
+    SkipSpan skip_space_scalar(const char* begin, const char* end) {
+        SkipSpan span{begin, 0, nullptr};
+
+        for (; span.stop < end && byte_isspace(*span.stop); span.stop++) {
+            if (*span.stop == '\n') {
+                span.newlines++;
+                span.last_newline = span.stop;
+            }
+        }
+        return span;
+    }
+
+    #if defined(__x86_64__)
+    // Skip over whitespace 16 bytes at a time.
+    SkipSpan skip_space_sse2(const char* begin, const char* end) {
+        SkipSpan span{begin, 0, nullptr};
+
+        const __m128i blank = _mm_set1_epi8(' ');
+        const __m128i lower = _mm_set1_epi8('\t');
+        const __m128i range = _mm_set1_epi8(4);
+        const __m128i lfeed = _mm_set1_epi8('\n');
+
+        while (span.stop + 16 <= end) {
+            const char*   at = span.stop;
+            const __m128i v  = _mm_loadu_si128((const __m128i*)at);
+
+            // Whitespace is ' ' or any byte within
+            // '\t' through '\r'.
+            __m128i off   = _mm_sub_epi8(v, lower);
+            __m128i ctrl  = _mm_cmpeq_epi8(_mm_min_epu8(off, range), off);
+            __m128i space = _mm_or_si128(_mm_cmpeq_epi8(v, blank), ctrl);
+
+            uint32_t smask = _mm_movemask_epi8(space);
+            uint32_t nmask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, lfeed));
+
+            bool done = smask != 0xFFFF;
+            if (done)
+                nmask &= (1u << __builtin_ctz(~smask)) - 1;
+            if (nmask) {
+                span.newlines += __builtin_popcount(nmask);
+                span.last_newline = at + (31 - __builtin_clz(nmask));
+            }
+            if (done) {
+                span.stop = at + __builtin_ctz(~smask);
+                return span;
+            }
+            span.stop = at + 16;
+        }
+
+        SkipSpan tail = skip_space_scalar(span.stop, end);
+        tail.newlines += span.newlines;
+        if (!tail.last_newline)
+            tail.last_newline = span.last_newline;
+        return tail;
+    }
+
+    // Skip over whitespace 32 bytes at a time.
+    __attribute__((target("avx2")))
+    SkipSpan skip_space_avx2(const char* begin, const char* end) {
+        SkipSpan span{begin, 0, nullptr};
+
+        const __m256i blank = _mm256_set1_epi8(' ');
+        const __m256i lower = _mm256_set1_epi8('\t');
+        const __m256i range = _mm256_set1_epi8(4);
+        const __m256i lfeed = _mm256_set1_epi8('\n');
+
+        while (span.stop + 32 <= end) {
+            const char*   at = span.stop;
+            const __m256i v  = _mm256_loadu_si256((const __m256i*)at);
+
+            __m256i off   = _mm256_sub_epi8(v, lower);
+            __m256i ctrl  = _mm256_cmpeq_epi8(_mm256_min_epu8(off, range), off);
+            __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(v, blank), ctrl);
+
+            uint32_t smask = _mm256_movemask_epi8(space);
+            uint32_t nmask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, lfeed));
+
+            bool done = smask != 0xFFFFFFFF;
+            if (done)
+                nmask &= (1u << __builtin_ctz(~smask)) - 1;
+            if (nmask) {
+                span.newlines += __builtin_popcount(nmask);
+                span.last_newline = at + (31 - __builtin_clz(nmask));
+            }
+            if (done) {
+                span.stop = at + __builtin_ctz(~smask);
+                return span;
+            }
+            span.stop = at + 32;
+        }
+
+        SkipSpan tail = skip_space_sse2(span.stop, end);
+        tail.newlines += span.newlines;
+        if (!tail.last_newline)
+            tail.last_newline = span.last_newline;
+        return tail;
+    }
+    #endif
+
+    typedef SkipSpan(*skip_space_func)(const char*, const char*);
+
+    // Pick the widest whitespace skipper the
+    // running CPU supports.
+    skip_space_func skip_space_select() {
+        #if defined(__x86_64__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return skip_space_avx2;
+        return skip_space_sse2;
+        #else
+        return skip_space_scalar;
+        #endif
+    }
+
+    static const skip_space_func skip_space_dispatch = skip_space_select();
+
+    // Skip over a run of whitespace in
+    // [begin, end), counting the newlines passed
+    // along the way.
+    SkipSpan skip_space(const char* begin, const char* end) {
+        return skip_space_dispatch(begin, end);
+    }
+
+    // Record the offset, plus `base`, of every
+    // newline in [begin, end) one byte at a time.
+    void index_newlines_scalar(
+        const char* begin,
+        const char* end,
+        uint32_t base,
+        std::vector<uint32_t>& newlines) {
+
+        for (const char* at = begin; at < end; at++) {
+            if (*at == '\n')
+                newlines.push_back(base + (at - begin));
+        }
+    }
+
+    #if defined(__x86_64__)
+    // Record the offset of every newline 16 bytes
+    // at a time.
+    void index_newlines_sse2(
+        const char* begin,
+        const char* end,
+        uint32_t base,
+        std::vector<uint32_t>& newlines) {
+
+        const __m128i lfeed = _mm_set1_epi8('\n');
+        const char*   at    = begin;
+
+        for (; at + 16 <= end; at += 16) {
+            __m128i  v    = _mm_loadu_si128((const __m128i*)at);
+            uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, lfeed));
+            for (; mask; mask &= mask - 1)
+                newlines.push_back(base + (at - begin) + __builtin_ctz(mask));
+        }
+        index_newlines_scalar(at, end, base + (at - begin), newlines);
+    }
+
+    // Record the offset of every newline 32 bytes
+    // at a time.
+    __attribute__((target("avx2")))
+    void index_newlines_avx2(
+        const char* begin,
+        const char* end,
+        uint32_t base,
+        std::vector<uint32_t>& newlines) {
+
+        const __m256i lfeed = _mm256_set1_epi8('\n');
+        const char*   at    = begin;
+
+        for (; at + 32 <= end; at += 32) {
+            __m256i  v    = _mm256_loadu_si256((const __m256i*)at);
+            uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, lfeed));
+            for (; mask; mask &= mask - 1)
+                newlines.push_back(base + (at - begin) + __builtin_ctz(mask));
+        }
+        index_newlines_sse2(at, end, base + (at - begin), newlines);
+    }
+    #endif
+
+    typedef void(*index_newlines_func)(const char*, const char*, uint32_t, std::vector<uint32_t>&);
+
+    // Pick the widest newline indexer the running
+    // CPU supports.
+    index_newlines_func index_newlines_select() {
+        #if defined(__x86_64__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return index_newlines_avx2;
+        return index_newlines_sse2;
+        #else
+        return index_newlines_scalar;
+        #endif
+    }
+
+    static const index_newlines_func index_newlines_dispatch = index_newlines_select();
+
+    // Append the offset, plus `base`, of every
+    // newline in [begin, end) to `newlines`.
+    void index_newlines(
+        const char* begin,
+        const char* end,
+        uint32_t base,
+        std::vector<uint32_t>& newlines) {
+
+        index_newlines_dispatch(begin, end, base, newlines);
+    }
+
+    // Skip to the end of the line; the newline
+    // itself is not skipped. Returns `end` if
+    // there is no newline left.
+    const char* skip_line(const char* begin, const char* end) {
+        const void* found = std::memchr(begin, '\n', end - begin);
+        return found ? (const char*)found : end;
+    }
+
+    // Summarise [begin, end) as though it had
+    // been skipped over, counting the newlines
+    // within it.
+    SkipSpan span_lines(const char* begin, const char* end) {
+        SkipSpan span{end, 0, nullptr};
+        while (begin < end) {
+            const char* found = (const char*)std::memchr(begin, '\n', end - begin);
+            if (!found)
+                break;
+            span.newlines++;
+            span.last_newline = found;
+            begin = found + 1;
+        }
+        return span;
+    }
+}
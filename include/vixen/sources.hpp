@@ -0,0 +1,455 @@
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "simd.hpp"
+
+namespace vixen::sources {
+    // Byte offset into some source.
+    typedef uint32_t Offset;
+    // Small id tokens use to refer back to the
+    // source they were lexed from. Id 0 is never
+    // handed out and refers to no source.
+    typedef uint16_t FileId;
+    // Line number and column of some offset.
+    typedef std::pair<uint32_t, uint32_t> Location;
+
+    // Offsets of every newline in some text, used
+    // to resolve byte offsets into line numbers
+    // and columns on demand.
+    class LineIndex {
+        private:
+            std::vector<Offset> newlines;
+            // Newlines dropped from the front of
+            // the index, and the offset of the last
+            // of them.
+            uint32_t dropped      = 0;
+            Offset   dropped_last = 0;
+
+        public:
+            // Index the newlines of [begin, end),
+            // which starts at offset `base`.
+            void append(const char* begin, const char* end, Offset base = 0) {
+                simd::index_newlines(begin, end, base, this->newlines);
+            }
+
+            // Forget the newlines before `offset`.
+            // They are still counted, but offsets
+            // before the last of them can no longer
+            // be located.
+            void drop(Offset offset) {
+                auto found = std::lower_bound(
+                    this->newlines.begin(),
+                    this->newlines.end(),
+                    offset);
+                size_t count = found - this->newlines.begin();
+                if (!count)
+                    return;
+                this->dropped     += count;
+                this->dropped_last = this->newlines[count - 1];
+                this->newlines.erase(this->newlines.begin(), found);
+            }
+
+            // Bytes allocated to the index.
+            size_t bytes() const {
+                return this->newlines.capacity() * sizeof(Offset);
+            }
+
+            // Line number and column of an offset.
+            // Columns count from the newline ending
+            // the previous line, the same as the
+            // symbol parsers do.
+            Location locate(Offset offset) const {
+                auto found = std::lower_bound(
+                    this->newlines.begin(),
+                    this->newlines.end(),
+                    offset);
+                uint32_t lines = found - this->newlines.begin();
+                Offset   last  = lines ? this->newlines[lines - 1] : this->dropped_last;
+                return {this->dropped + lines + 1, offset - last};
+            }
+    };
+
+    // An immutable buffer of program text.
+    //
+    // Parsers do not copy their input, they keep
+    // a shared reference to its `Source` and hand
+    // out views into it. Those views remain valid
+    // for as long as any reference to the source
+    // is held.
+    class Source {
+        protected:
+            const char* bytes  = nullptr;
+            size_t      length = 0;
+
+            // Built on first use, most sources are
+            // never asked for a location.
+            mutable LineIndex      lines;
+            mutable std::once_flag lines_built;
+
+        public:
+            // Id this source is registered under,
+            // see `source_register`.
+            mutable FileId id = 0;
+            // Name of the file this text was read
+            // from, if any.
+            std::string name;
+
+        public:
+            Source() {}
+            Source(const std::string& name) {
+                this->name = name;
+            }
+            virtual ~Source() {}
+
+            // Do not allow copies; views are handed
+            // out against this buffer's address.
+            Source(const Source&) = delete;
+            Source& operator=(const Source&) = delete;
+
+            // Line number and column of an offset
+            // into this source.
+            virtual Location locate(Offset offset) const {
+                std::call_once(this->lines_built, [this]() {
+                    this->lines.append(this->bytes, this->bytes + this->length);
+                });
+                return this->lines.locate(offset);
+            }
+
+            // The whole buffer as a view.
+            std::string_view view() const {
+                return std::string_view(this->bytes, this->length);
+            }
+    };
+
+    typedef std::shared_ptr<const Source> SourceRef;
+
+    // Sources tokens may refer back to by id.
+    // Only weak references are held; a source's
+    // id is recycled once it has been released.
+    static std::vector<std::weak_ptr<const Source>> SourceRegistry(1);
+    static std::mutex SourceRegistryLock;
+
+    // Get the id of a source, registering it if
+    // need be. Returns 0 if every id is in use.
+    FileId source_register(const SourceRef& source) {
+        std::lock_guard<std::mutex> lock(SourceRegistryLock);
+        if (source->id)
+            return source->id;
+
+        size_t id = 1;
+        while (id < SourceRegistry.size() && !SourceRegistry[id].expired())
+            id++;
+        if (id > UINT16_MAX)
+            return 0;
+
+        if (id == SourceRegistry.size())
+            SourceRegistry.emplace_back(source);
+        else
+            SourceRegistry[id] = source;
+
+        source->id = id;
+        return source->id;
+    }
+
+    // Get a registered source by its id. Returns
+    // `nullptr` if the source has been released.
+    SourceRef source_lookup(FileId id) {
+        std::lock_guard<std::mutex> lock(SourceRegistryLock);
+        if (!id || id >= SourceRegistry.size())
+            return nullptr;
+        return SourceRegistry[id].lock();
+    }
+
+    // Source text owned by a string.
+    class StringSource : public Source {
+        private:
+            std::string buffer;
+
+        public:
+            StringSource(std::string buffer, const std::string& name = "") : Source(name) {
+                this->buffer = std::move(buffer);
+                this->bytes  = this->buffer.data();
+                this->length = this->buffer.length();
+            }
+    };
+
+    // Source text mapped from a file. The file is
+    // scanned in place, so pages are only read in
+    // as the parser reaches them.
+    class MappedSource : public Source {
+        private:
+            size_t mapped;
+
+        public:
+            MappedSource(void* address, size_t mapped, size_t length, const std::string& name = "") : Source(name) {
+                this->bytes  = (const char*)address;
+                this->length = length;
+                this->mapped = mapped;
+            }
+
+            ~MappedSource() {
+                munmap((void*)this->bytes, this->mapped);
+            }
+    };
+
+    // Take ownership of some string as program
+    // text.
+    SourceRef source_from_string(std::string data, const std::string& name = "") {
+        return std::make_shared<StringSource>(std::move(data), name);
+    }
+
+    // Read the remainder of some stream as
+    // program text.
+    //
+    // Text read in, however it is read, has
+    // every line terminated by a newline,
+    // including the last. So a file lexes and
+    // locates the same whether it was mapped,
+    // piped or streamed.
+    SourceRef source_from_stream(std::istream& stream, const std::string& name = "") {
+        std::string data(
+            (std::istreambuf_iterator<char>(stream)),
+            std::istreambuf_iterator<char>());
+
+        if (data.length() && data.back() != '\n')
+            data.push_back('\n');
+        return source_from_string(std::move(data), name);
+    }
+
+    // Read everything left in a file descriptor
+    // as program text. This is our fallback for
+    // inputs that cannot be mapped, such as pipes
+    // and stdin. Returns `nullptr` on a failed
+    // read. Anything other than `text`, such as
+    // a token cache, is read byte for byte.
+    SourceRef source_from_fd(int fd, const std::string& name = "", bool text = true) {
+        struct stat info;
+        std::string data;
+        size_t      chunk = 1 << 16;
+
+        if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode))
+            data.reserve(info.st_size);
+
+        while (1) {
+            size_t  length = data.length();
+            data.resize(length + chunk);
+
+            ssize_t count;
+            do {
+                count = read(fd, data.data() + length, chunk);
+            } while (count < 0 && errno == EINTR);
+
+            if (count < 0) {
+                return nullptr;
+            }
+
+            data.resize(length + count);
+            if (count == 0)
+                break;
+        }
+
+        if (text && data.length() && data.back() != '\n')
+            data.push_back('\n');
+        return source_from_string(std::move(data), name);
+    }
+
+    // Open a file as program text. Regular files
+    // are mapped and scanned in place, anything
+    // else is read in through `source_from_fd`.
+    // Files other than `text` are read byte for
+    // byte. Returns `nullptr` if the file cannot
+    // be opened or read.
+    SourceRef source_open(const std::string& path, bool text = true) {
+        struct stat info;
+        SourceRef   source;
+
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return nullptr;
+
+        if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+            // Reserve a byte past the end of the
+            // file, then map the file over the
+            // front of the reservation. A missing
+            // final newline is written there, on a
+            // private copy of the last page only.
+            size_t length  = info.st_size;
+            size_t mapped  = length + 1;
+            void*  address = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (address != MAP_FAILED) {
+                if (mmap(address, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+                    munmap(address, mapped);
+                } else {
+                    char* bytes = (char*)address;
+                    if (text && bytes[length - 1] != '\n')
+                        bytes[length++] = '\n';
+                    mprotect(address, mapped, PROT_READ);
+                    madvise(address, length, MADV_SEQUENTIAL);
+                    source = std::make_shared<MappedSource>(address, mapped, length, path);
+                }
+            }
+        }
+
+        if (!source)
+            source = source_from_fd(fd, path, text);
+
+        close(fd);
+        return source;
+    }
+
+    // Default number of bytes read from a stream
+    // at a time.
+    #define STREAM_CHUNK_SIZE (64 << 10)
+
+    // A bounded window over a file descriptor.
+    //
+    // Text is read onto the end of the window a
+    // chunk at a time, and text that is no longer
+    // needed is dropped from the front. The
+    // window only grows when a single line or
+    // symbol does not fit, so resident memory
+    // stays constant no matter the input length.
+    //
+    // Unlike other sources, the text viewed
+    // through a stream changes as it is read.
+    class Stream : public Source {
+        private:
+            std::vector<char> buffer;
+            size_t chunk;
+            Offset dropped;
+            bool   eof;
+            bool   newline;
+            int    fd;
+            int    failure;
+
+        public:
+            Stream(int fd, const std::string& name = "", size_t chunk = STREAM_CHUNK_SIZE) : Source(name) {
+                this->chunk   = chunk ? chunk : 1;
+                this->dropped = 0;
+                this->eof     = false;
+                this->newline = true;
+                this->fd      = fd;
+                this->failure = 0;
+                this->buffer.resize(this->chunk);
+                this->bytes = this->buffer.data();
+            }
+
+            // Bytes currently allocated to the
+            // window.
+            size_t capacity() const {
+                return this->buffer.size();
+            }
+
+            // Bytes currently allocated to the
+            // window and its line index.
+            size_t resident() const {
+                return this->buffer.size() + this->lines.bytes();
+            }
+
+            // Offset of the start of the window
+            // from the start of the stream.
+            Offset base() const {
+                return this->dropped;
+            }
+
+            // The stream has no more text to read
+            // onto the window.
+            bool exhausted() const {
+                return this->eof;
+            }
+
+            // The `errno` of a failed read, which
+            // also exhausts the stream, or 0 if the
+            // stream ended or is still being read.
+            int error() const {
+                return this->failure;
+            }
+
+            // Line number and column of an offset
+            // from the start of the stream, which
+            // must be within the window. Lines are
+            // indexed as they are read in, and
+            // dropped from the index along with the
+            // text.
+            Location locate(Offset offset) const override {
+                return this->lines.locate(offset);
+            }
+
+            // Drop the first `count` bytes of the
+            // window.
+            void drop(size_t count) {
+                std::memmove(
+                    this->buffer.data(),
+                    this->buffer.data() + count,
+                    this->length - count);
+                this->length  -= count;
+                this->dropped += count;
+                this->lines.drop(this->dropped);
+            }
+
+            // Read up to one chunk onto the end of
+            // the window, growing the window if it
+            // is full. Returns the number of bytes
+            // read.
+            size_t fill() {
+                if (this->eof)
+                    return 0;
+                if (this->buffer.size() - this->length < this->chunk)
+                    this->buffer.resize(this->length + this->chunk);
+                this->bytes = this->buffer.data();
+
+                // Streams over no descriptor are read
+                // as empty rather than failing.
+                ssize_t count = 0;
+                while (this->fd >= 0) {
+                    count = read(this->fd, this->buffer.data() + this->length, this->chunk);
+                    if (count >= 0 || errno != EINTR)
+                        break;
+                }
+
+                // A failed read is not the end of the
+                // text, so is recorded rather than
+                // terminated like one.
+                if (count < 0) {
+                    this->failure = errno;
+                    this->eof     = true;
+                    return 0;
+                }
+
+                // Terminate the last line as other
+                // sources do.
+                if (count <= 0 && !this->newline) {
+                    this->buffer[this->length] = '\n';
+                    count = 1;
+                }
+                if (count <= 0) {
+                    this->eof = true;
+                    return 0;
+                }
+
+                this->newline = this->buffer[this->length + count - 1] == '\n';
+                this->lines.append(
+                    this->bytes + this->length,
+                    this->bytes + this->length + count,
+                    this->dropped + this->length);
+                this->length += count;
+                return count;
+            }
+    };
+}
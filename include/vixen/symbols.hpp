@@ -1,80 +1,143 @@
 #pragma once
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <ranges>
+#include <stdexcept>
 #include <string.h>
+#include <string_view>
+
+#include "simd.hpp"
+#include "sources.hpp"
 
 using namespace std;
 
 #define MAX_SIZET (size_t)(-1)
 
 typedef std::string Symbol;
+// A symbol as a view into the buffer it was
+// parsed from.
+typedef std::string_view SymbolView;
 typedef uint Column;
 typedef uint Lineno;
 #define TRIPLET(T) std::tuple<Lineno, Column, T>
 
 namespace vixen::symbols {
-    bool char_in_string(const char ch, const std::string &str) {
-        return str.find(ch) != MAX_SIZET;
+    // Character classes a byte may belong to.
+    // Each byte value maps to a set of these
+    // flags in `CharClassTable`.
+    enum CharClass : uint16_t {
+        CHAR_COMMENT  = 1 << 0,
+        CHAR_DIGIT    = 1 << 1,
+        CHAR_DIGITEXT = 1 << 2,
+        CHAR_DIGITSEP = 1 << 3,
+        CHAR_GROUP    = 1 << 4,
+        CHAR_NAME     = 1 << 5,
+        CHAR_NEWLINE  = 1 << 6,
+        CHAR_NOPARSE  = 1 << 7,
+        CHAR_NUMERIC  = 1 << 8,
+        CHAR_STRING   = 1 << 9,
+        CHAR_TERM     = 1 << 10
+    };
+
+    // Build the character classification table
+    // at compile time. Every class is described
+    // by the same literals the predicates used to
+    // search through.
+    constexpr std::array<uint16_t, 256> char_class_table_init() {
+        std::array<uint16_t, 256> table{};
+        auto mark = [&table](const char* chars, uint16_t flag) {
+            for (; *chars; ++chars)
+                table[(uint8_t)*chars] |= flag;
+        };
+
+        mark("#", CHAR_COMMENT);
+        mark("1234567890", CHAR_DIGIT);
+        mark(
+            "abcdefghijklmnopqrstuvwxyz"
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+            "1234567890"
+            "!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~",
+            CHAR_DIGITEXT);
+        mark("-_.bdxo", CHAR_DIGITSEP);
+        mark(")}][{(", CHAR_GROUP);
+        mark(
+            "abcdefghijklmnopqrstuvwxyz"
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+            "1234567890"
+            "_",
+            CHAR_NAME);
+        mark("\n", CHAR_NEWLINE);
+        mark(" \t\n\r\v\f", CHAR_NOPARSE);
+        mark("1234567890-_.xdbo", CHAR_NUMERIC);
+        mark("'`\"", CHAR_STRING);
+        mark(";", CHAR_TERM);
+
+        return table;
     }
 
-    bool char_iscomment(const char ch) {
-        return char_in_string(ch, "#");
+    constexpr std::array<uint16_t, 256> CharClassTable = char_class_table_init();
+
+    // Character belongs to any of the given
+    // classes. Costs a single table load.
+    constexpr bool char_hasclass(const char ch, const uint16_t classes) {
+        return CharClassTable[(uint8_t)ch] & classes;
     }
 
-    bool char_isdigitchar(const char ch) {
-        return char_in_string(ch, "1234567890");
+    bool char_in_string(const char ch, const std::string_view str) {
+        return str.find(ch) != std::string_view::npos;
     }
 
-    bool char_isdigitext(const char ch) {
-        return char_in_string(
-            ch,
-            "abcdefghijklmnopqrstuvwxyz"
-            "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-            "1234567890"
-            "!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~");
+    constexpr bool char_iscomment(const char ch) {
+        return char_hasclass(ch, CHAR_COMMENT);
     }
 
-    bool char_isdigitsep(const char ch) {
-        return char_in_string(ch, "-_.bdxo");
+    constexpr bool char_isdigitchar(const char ch) {
+        return char_hasclass(ch, CHAR_DIGIT);
     }
 
-    bool char_isgroupchar(const char ch) {
-        return char_in_string(ch, ")}][{(");
+    constexpr bool char_isdigitext(const char ch) {
+        return char_hasclass(ch, CHAR_DIGITEXT);
     }
 
-    bool char_isnamechar(const char ch) {
-        return char_in_string(
-            ch,
-            "abcdefghijklmnopqrstuvwxyz"
-            "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-            "1234567890"
-            "_");
+    constexpr bool char_isdigitsep(const char ch) {
+        return char_hasclass(ch, CHAR_DIGITSEP);
+    }
+
+    constexpr bool char_isgroupchar(const char ch) {
+        return char_hasclass(ch, CHAR_GROUP);
     }
 
-    bool char_isnewline(const char ch) {
-        return char_in_string(ch, "\n");
+    constexpr bool char_isnamechar(const char ch) {
+        return char_hasclass(ch, CHAR_NAME);
     }
 
-    bool char_isnoparse(const char ch) {
-        return char_in_string(ch, " \t\n\r\v\f");
+    constexpr bool char_isnewline(const char ch) {
+        return char_hasclass(ch, CHAR_NEWLINE);
     }
 
-    bool char_ispuncchar(const char ch) {
+    constexpr bool char_isnoparse(const char ch) {
+        return char_hasclass(ch, CHAR_NOPARSE);
+    }
+
+    constexpr bool char_ispuncchar(const char ch) {
         return !char_isnamechar(ch);
     }
 
-    bool char_isstrchar(const char ch) {
-        return char_in_string(ch, "'`\"");
+    constexpr bool char_isstrchar(const char ch) {
+        return char_hasclass(ch, CHAR_STRING);
     }
 
-    bool char_istermchar(const char ch) {
-        return char_in_string(ch, ";");
+    constexpr bool char_istermchar(const char ch) {
+        return char_hasclass(ch, CHAR_TERM);
     }
 
-    bool symbol_isname(const Symbol &symbol) {
+    bool symbol_isname(const SymbolView symbol) {
         if (symbol.length() == 0)
             return false;
         if (char_isdigitchar(symbol[0]))
@@ -95,47 +158,138 @@ namespace vixen::symbols {
         return true;
     }
 
-    bool symbol_isnumeric(const Symbol &symbol) {
-        bool result = false;
-
-        // Byte array might be numeric if  any chars
-        // in the sequence are digits.
-        for (char ch : symbol)
-            result += char_isdigitchar(ch);
-        if (!result)
-            return result;
-
-        uint base_notation = 0;
-        // Byte array is numeric if there is not mixing
-        // of floating point ('.') char and special
-        // base notations (0x, 0d, 0b, 0o).
-        for (char ch : "xdbo") {
-            if (char_in_string(ch, symbol) && char_in_string('.', symbol))
-                return false;
-            if (char_in_string(ch, symbol))
-                base_notation = (uint)ch;
+    // Kinds of numeric literal.
+    enum NumericKind : uint8_t {
+        NUMERIC_BIN,
+        NUMERIC_FLT,
+        NUMERIC_HEX,
+        NUMERIC_INT,
+        NUMERIC_OCT
+    };
+
+    // Recognizes numeric symbols one char at a
+    // time.
+    //
+    // Whether a symbol is numeric only depends on
+    // the classes of the chars in it, which base
+    // notations it holds and how many '.' it
+    // holds, so each char updates the state once
+    // and nothing is ever rescanned.
+    class NumericScan {
+    private:
+        uint16_t classes_all = CHAR_NUMERIC | CHAR_DIGITEXT;
+        uint16_t classes_any = 0;
+        // Base notations seen, 'x', 'd', 'b' and
+        // 'o' in that order from the lowest bit.
+        uint8_t  notation = 0;
+        // Prefixes seen, '0b', '0x' and '0o' in
+        // that order from the lowest bit.
+        uint8_t  prefixes = 0;
+        uint32_t dots     = 0;
+        uint32_t length   = 0;
+        char     last     = '\0';
+
+    public:
+        constexpr NumericScan() {}
+
+        constexpr NumericScan(const SymbolView symbol) {
+            for (const char& ch : symbol)
+                this->push(ch);
         }
 
-        // Byte array is numeric if only digits are
-        // found in the sequence.
-        for (const char &ch : symbol) {
-            // If parsing for base 10, binary or octal.
-            if (base_notation == 0 || base_notation == 98 || base_notation == 111) {
-                if (!char_in_string(ch, "1234567890-_.xdbo"))
-                    return false;
-                // If parsing hex or some other base.
+        // Append a char to the symbol scanned so
+        // far.
+        constexpr void push(const char ch) {
+            uint16_t classes = CharClassTable[(uint8_t)ch];
+            this->classes_all &= classes;
+            this->classes_any |= classes;
+
+            switch (ch) {
+                case 'x': this->notation |= 1; break;
+                case 'd': this->notation |= 2; break;
+                case 'b': this->notation |= 4; break;
+                case 'o': this->notation |= 8; break;
+                case '.': this->dots++; break;
             }
-            else {
-                if (!char_isdigitext(ch))
+            if (this->last == '0') {
+                switch (ch) {
+                    case 'b': this->prefixes |= 1; break;
+                    case 'x': this->prefixes |= 2; break;
+                    case 'o': this->prefixes |= 4; break;
+                }
+            }
+
+            this->last = ch;
+            this->length++;
+        }
+
+        // Symbol scanned so far is numeric.
+        constexpr bool isnumeric() const {
+            // Might be numeric if any chars in the
+            // sequence are digits.
+            if (!(this->classes_any & CHAR_DIGIT))
+                return false;
+
+            // Floating point ('.') chars do not mix
+            // with special base notations.
+            if (this->notation && this->dots)
+                return false;
+
+            // The last special base notation found,
+            // by order of 'xdbo', wins. Base 10,
+            // binary and octal only allow numeric
+            // chars, hex and the rest any digit
+            // text.
+            if (this->notation < 4) {
+                if (this->notation && !(this->classes_all & CHAR_DIGITEXT))
                     return false;
+                if (!this->notation && !(this->classes_all & CHAR_NUMERIC))
+                    return false;
+            } else if (!(this->classes_all & CHAR_NUMERIC)) {
+                return false;
             }
+
+            return this->dots < 2;
+        }
+
+        // Symbol scanned so far may be followed
+        // by `next` in a numeric symbol.
+        constexpr bool accepts(const char next) const {
+            // Some exceptions are made in the event
+            // that the first char of a symbol might
+            // be a '.' or the numeric might be
+            // signed '-'.
+            bool lead = this->length == 1 && (this->last == '.' || this->last == '-');
+            if (!lead && !this->isnumeric())
+                return false;
+
+            // Floating point numerics must not be
+            // followed by punctuation.
+            if (this->dots)
+                return char_isnamechar(next);
+            return char_hasclass(next, CHAR_DIGIT | CHAR_DIGITSEP | CHAR_NAME);
+        }
+
+        // Kind of numeric symbol scanned so far.
+        // Only meaningful if it is numeric.
+        constexpr NumericKind kind() const {
+            if (this->prefixes & 1)
+                return NUMERIC_BIN;
+            if (this->dots)
+                return NUMERIC_FLT;
+            if (this->prefixes & 2)
+                return NUMERIC_HEX;
+            if (this->prefixes & 4)
+                return NUMERIC_OCT;
+            return NUMERIC_INT;
         }
+    };
 
-        // I hate this so much about C++.
-        return (std::ranges::count(symbol.begin(), symbol.end(), '.') < 2);
+    bool symbol_isnumeric(const SymbolView symbol) {
+        return NumericScan(symbol).isnumeric();
     }
 
-    bool symbol_ispunc(const Symbol &symbol) {
+    bool symbol_ispunc(const SymbolView symbol) {
         if (symbol.length() == 0)
             return false;
 
@@ -149,110 +303,162 @@ namespace vixen::symbols {
         return true;
     }
 
-    bool symbol_isstrsym(const Symbol &symbol) {
-        std::string stringsyms[] = {"'", "'''", "`", "```", "\"", "\"\"\""};
-
-        if (symbol.length() < 1)
+    bool symbol_isstrsym(const SymbolView symbol) {
+        // One of ', `, or ", alone or tripled.
+        if (symbol.length() != 1 && symbol.length() != 3)
+            return false;
+        if (symbol[0] != '\'' && symbol[0] != '`' && symbol[0] != '"')
             return false;
 
-        for (std::string sym : stringsyms)
-            if (sym == symbol)
-                return true;
+        for (const char& ch : symbol)
+            if (ch != symbol[0])
+                return false;
 
-        return false;
+        return true;
     }
 
-    bool symbol_istermed(const Symbol &symbol, const char next) {
+    bool symbol_istermed(const SymbolView symbol, const char next) {
         return symbol.length() > 0 && !char_in_string(';', symbol) && char_istermchar(next);
     }
 
-    bool symbol_next_isvalidname(const Symbol &symbol, const char next) {
+    bool symbol_next_isvalidname(const SymbolView symbol, const char next) {
         return symbol_isname(symbol) && !char_ispuncchar(next);
     }
 
-    bool symbol_next_isvalidnum(const Symbol &symbol, const char next) {
-        // Some exceptions are made in the event
-        // that the first char of a symbol might
-        // be a '.' or the numeric might be signed
-        // '-'.
-        if (
-            !symbol_isnumeric(symbol) && symbol.compare(".") != 0 && symbol.compare("-") != 0)
-            return false;
-
-        // If symbol has floating point ('.').
-        if (char_in_string('.', symbol)) {
-            // Next character should not be
-            // punctuation.
-            return !char_ispuncchar(next);
-        }
-
-        return char_isdigitchar(next) || char_isdigitsep(next) || !char_ispuncchar(next);
+    bool symbol_next_isvalidnum(const SymbolView symbol, const char next) {
+        return NumericScan(symbol).accepts(next);
     }
 
-    bool symbol_next_isvalidpunc(const Symbol &symbol, const char next) {
+    bool symbol_next_isvalidpunc(const SymbolView symbol, const char next) {
         return !(symbol_ispunc(symbol) && char_isnamechar(next));
     }
 
-    template <typename T>
     // Parses a buffer of data into symbols that are
     // usable for token parsing.
-    class SymbolParser {
-    public:
+    //
+    // Parsers are plain classes checked against
+    // this concept rather than overrides of a
+    // virtual interface, so `end()`, `head()` and
+    // friends are inlined into the scanning loops.
+    template <typename P>
+    concept SymbolParsing = requires(P& parser) {
         // Read head is at the end of data stream or
         // not.
-        virtual bool end() = 0;
+        { parser.end() } -> std::convertible_to<bool>;
         // Character at read head.
-        virtual char head() = 0;
+        { parser.head() } -> std::convertible_to<char>;
         // Parse next symbol.
+        parser.next();
+    };
+
+    template <typename T>
+    // Dynamically dispatched symbol parser, for
+    // where the kind of parser is only known at
+    // runtime. See `DynamicSymbolParser`.
+    class SymbolParser {
+    public:
+        virtual ~SymbolParser() {}
+        virtual bool end() = 0;
+        virtual char head() = 0;
         virtual T next() = 0;
     };
 
+    // Adapts a statically dispatched parser to
+    // the `SymbolParser` interface.
+    template <SymbolParsing P, typename T = decltype(std::declval<P&>().next())>
+    class DynamicSymbolParser : public SymbolParser<T> {
+    private:
+        P parser;
+
+    public:
+        DynamicSymbolParser(P parser) : parser(std::move(parser)) {}
+
+        bool end() {
+            return this->parser.end();
+        }
+
+        char head() {
+            return this->parser.head();
+        }
+
+        T next() {
+            return this->parser.next();
+        }
+    };
+
     // Populates a class definition with empty
     // constructors that inherit directly from the
     // parent `BasicSymbolParser`.
-    #define BasicSymbolParser__init__(CLASS_NAME, RT)                  \
-        CLASS_NAME() : BasicSymbolParser<RT>() {}                      \
-        CLASS_NAME(std::string &data) : BasicSymbolParser<RT>(data) {} \
-        CLASS_NAME(std::ifstream &file, const std::string &filename = "") : BasicSymbolParser<RT>(file, filename) {}
+    #define BasicSymbolParser__init__(CLASS_NAME, RT)                                                                  \
+        CLASS_NAME() : BasicSymbolParser<RT>() {}                                                                      \
+        CLASS_NAME(std::string &data) : BasicSymbolParser<RT>(data) {}                                                 \
+        CLASS_NAME(std::ifstream &file, const std::string &filename = "") : BasicSymbolParser<RT>(file, filename) {}   \
+        CLASS_NAME(sources::SourceRef source) : BasicSymbolParser<RT>(source) {}                                       \
+        CLASS_NAME(sources::SourceRef source, std::string_view data, sources::Offset base, uint lineno = 1) :          \
+            BasicSymbolParser<RT>(source, data, base, lineno) {}
 
     // Parses generic symbols into a tuple of metadata
     // `(line_number, start_column, symbol)`.
+    //
+    // Symbols are views into the parser's source.
+    // The source is shared between copies of the
+    // parser and outlives all of them, so views
+    // remain valid for as long as the parser or
+    // any copy of it does.
     template <typename T>
-    class BasicSymbolParser : public SymbolParser<T> {
+    class BasicSymbolParser {
     protected:
-        std::string data;
+        std::string_view data;
+        sources::Offset data_base = 0;
         uint dimension_line;
-        std::string file;
+        std::string_view file;
+        sources::FileId file_id = 0;
         uint last_line_at;
         uint read_head;
+        sources::SourceRef source;
         bool string_parsing;
-        std::string symbol_ribbon[3];
+        SymbolView symbol_ribbon[3];
 
     public:
         BasicSymbolParser() {}
 
-        BasicSymbolParser(const std::string data) {
-            this->data = data;
+        BasicSymbolParser(const std::string data) :
+            BasicSymbolParser(sources::source_from_string(data)) {}
+
+        BasicSymbolParser(std::ifstream &file, const std::string &filename = "") :
+            BasicSymbolParser(sources::source_from_stream(file, filename)) {}
+
+        // Sources that failed to open are
+        // `nullptr`, and throw
+        // `std::invalid_argument`.
+        BasicSymbolParser(sources::SourceRef source) {
+            if (!source)
+                throw std::invalid_argument("parse of a source that failed to open");
+            this->source = source;
+            this->data = source->view();
+            this->file = source->name;
+            this->file_id = sources::source_register(source);
             this->dimension_line = 1;
             this->last_line_at = 0;
             this->read_head = 0;
             this->string_parsing = false;
         }
 
-        BasicSymbolParser(std::ifstream &file, const std::string &filename = "") {
-            this->file = filename;
-            std::string buf;
-            while (std::getline(file, buf))
-                this->data.append(buf + "\n");
-
-            this->dimension_line = 1;
-            this->last_line_at = 0;
-            this->read_head = 0;
-            this->string_parsing = false;
+        // Parse `data`, the text of `source` from
+        // offset `base` on, as though what came
+        // before it had been parsed outside of a
+        // string, ending on line `lineno`. For
+        // sources that keep their text in pieces
+        // rather than in one buffer.
+        BasicSymbolParser(sources::SourceRef source, std::string_view data, sources::Offset base, uint lineno = 1) :
+            BasicSymbolParser(source) {
+            this->data = data;
+            this->data_base = base;
+            this->dimension_line = lineno;
         }
 
         // Last symbol parsed by this parser.
-        const std::string last_symbol() {
+        SymbolView last_symbol() {
             return this->symbol_ribbon[2];
         }
 
@@ -265,13 +471,28 @@ namespace vixen::symbols {
             this->read_head++;
         }
 
+        // Apply line bookkeeping for a run of
+        // bytes skipped over in bulk and move the
+        // read head past it.
+        void advance_span(const simd::SkipSpan& span) {
+            const char* begin = this->data.data();
+            if (span.newlines) {
+                this->dimension_line += span.newlines;
+                this->last_line_at = span.last_newline - begin;
+            }
+            this->read_head = span.stop - begin;
+        }
+
         // Move the read head to next valid
         // non-whitespace character.
         void advancew() {
-            if (this->string_parsing)
+            if (this->string_parsing || this->end())
                 return;
-            while (char_isnoparse(this->head()) && !this->end())
-                this->advance();
+
+            const char* begin = this->data.data();
+            this->advance_span(simd::skip_space(
+                begin + this->read_head,
+                begin + this->data.length()));
         }
 
         // Move the read head to next valid
@@ -279,13 +500,18 @@ namespace vixen::symbols {
         void advancec() {
             if (this->string_parsing)
                 return;
-            while (char_iscomment(this->head())) {
+
+            const char* begin = this->data.data();
+            while (!this->end() && char_iscomment(this->head())) {
                 // Comments cannot exist inline
                 // with code. The end of comments
                 // are determined based on the end
-                // of line or EOF.
-                while (!char_isnewline(this->head()) && !this->end())
-                    this->advance();
+                // of line or EOF. No newlines can
+                // be found before then, so the
+                // whole line is skipped at once.
+                this->read_head = simd::skip_line(
+                    begin + this->read_head,
+                    begin + this->data.length()) - begin;
 
                 // Second pass ensures additional
                 // whitespace after a comment is
@@ -315,21 +541,74 @@ namespace vixen::symbols {
             return this->dimension_line;
         }
 
+        // Offset of the read head into data.
+        uint position() {
+            return this->read_head;
+        }
+
+        // Move the read head to `offset`, which
+        // must be the start of a line, as though
+        // everything before it had been parsed
+        // outside of a string.
+        void seek(uint offset) {
+            auto const [lineno, column] = this->source->locate(this->data_base + offset);
+            this->dimension_line = lineno;
+            this->last_line_at   = offset - column;
+            this->read_head      = offset;
+            this->string_parsing = false;
+            for (auto& symbol : this->symbol_ribbon)
+                symbol = SymbolView();
+        }
+
         // Get a 'slice' of `head` length from
         // data stream relative to read head.
-        std::string lookahead(uint head) {
+        SymbolView lookahead(uint head) {
             return this->data.substr(this->read_head, head);
         }
 
+        // Offset of a symbol from the start of the
+        // source. Symbols not parsed from the
+        // source, such as EOF, are placed at the
+        // read head.
+        sources::Offset offset_of(SymbolView symbol) {
+            if (this->symbol_isend(symbol))
+                return this->data_base + this->read_head;
+            return this->data_base + (symbol.data() - this->data.data());
+        }
+
+        // Symbol marks the end of input, EOF or
+        // EOL, rather than being parsed from it.
+        bool symbol_isend(SymbolView symbol) {
+            const char* begin = this->data.data();
+            return symbol.data() < begin || symbol.data() > begin + this->data.length();
+        }
+
+        // Character `offset` places past the read
+        // head, or '\0' past the end of data.
+        char peek(uint offset) {
+            if (this->read_head + offset >= this->data.length())
+                return '\0';
+            return this->data[this->read_head + offset];
+        }
+
         // The last symbol parsed is equal to the
         // lookahead slice.
         bool lookahead_matchlast() {
-            std::string last = this->last_symbol();
-            std::string look = this->lookahead(last.length());
-            return look == last;
+            SymbolView last = this->last_symbol();
+            return this->lookahead(last.length()) == last;
         }
 
+        // Parse the next symbol as an owned
+        // string.
         TRIPLET(Symbol) next_raw() {
+            auto const [lineno, column, symbol] = this->next_view();
+            return {lineno, column, Symbol(symbol)};
+        }
+
+        // Parse the next symbol as a view into
+        // the source. Parsing this way does not
+        // allocate.
+        TRIPLET(SymbolView) next_view() {
             // Advance past all whitespace and chars
             // considered invalid for parsing.
             // This includes characters after a comment
@@ -337,18 +616,18 @@ namespace vixen::symbols {
             this->advancew();
             this->advancec();
 
-            std::string symbol;
-            TRIPLET(std::string) token;
+            TRIPLET(SymbolView) token;
 
             if (this->end()) {
                 if (this->lineno() > 1)
-                    symbol = "EOF";
-                else
-                    symbol = "EOL";
-                return {this->lineno(), this->column(), symbol};
+                    return {this->lineno(), this->column(), "EOF"};
+                return {this->lineno(), this->column(), "EOL"};
             }
 
-            if (this->string_parsing) {
+            if (this->string_parsing && symbol_isstrsym(this->last_symbol())) {
+                token = this->next_string();
+            }
+            else if (this->string_parsing) {
                 token = this->next_punc();
             }
             else if (char_isnamechar(this->head()) && !char_isdigitchar(this->head())) {
@@ -357,7 +636,7 @@ namespace vixen::symbols {
             else if (char_isdigitchar(this->head())) {
                 token = this->next_numeric();
             }
-            else if (char_isdigitsep(this->head()) && char_isdigitchar(this->lookahead(2)[1])) {
+            else if (char_isdigitsep(this->head()) && char_isdigitchar(this->peek(1))) {
                 token = this->next_numeric();
             }
             else {
@@ -371,93 +650,148 @@ namespace vixen::symbols {
             return token;
         }
 
+        // Slice of the source from `start` up to
+        // the read head.
+        SymbolView symbol_from(uint start) {
+            return this->data.substr(start, this->read_head - start);
+        }
+
         // Parse next name symbol.
-        TRIPLET(Symbol) next_name() {
-            std::string symbol("");
+        TRIPLET(SymbolView) next_name() {
+            uint start  = this->read_head;
             uint column = this->column();
             uint lineno = this->lineno();
-            char head = this->head();
 
+            // Names never contain newlines, so the
+            // read head is moved without any line
+            // bookkeeping.
             while (1) {
-                symbol += head;
-                this->advance();
-
-                head = this->head();
-                if (char_isnoparse(head))
-                    break;
-                if (char_iscomment(head))
-                    break;
-                if (char_istermchar(head))
-                    break;
-                // Punctuation cannot exist in a name.
-                // Unless said name is numeric, then
-                // '.' is accepted.
-                if (!symbol_next_isvalidname(symbol, head))
-                    break;
+                this->read_head++;
                 if (this->end())
                     break;
+
+                // Whitespace, comments, terminators
+                // and punctuation cannot exist in a
+                // name. Symbol is always a valid name
+                // here, so one class lookup on the
+                // next char decides.
+                if (!char_isnamechar(this->head()))
+                    break;
             }
 
-            return {lineno, column, symbol};
+            return {lineno, column, this->symbol_from(start)};
         }
 
         // Parse next numeric symbol.
-        TRIPLET(Symbol) next_numeric() {
-            std::string symbol("");
+        TRIPLET(SymbolView) next_numeric() {
+            uint start  = this->read_head;
             uint column = this->column();
             uint lineno = this->lineno();
             char head = this->head();
+            NumericScan scan;
 
+            // Nor do numerics. Chars are fed to the
+            // scan as they are accepted, so the
+            // symbol is only ever read once.
             while (1) {
-                symbol += head;
-                this->advance();
+                scan.push(head);
+                this->read_head++;
+                if (this->end())
+                    break;
 
                 head = this->head();
-                if (char_isnoparse(head))
+                if (char_hasclass(head, CHAR_NOPARSE | CHAR_COMMENT | CHAR_TERM))
                     break;
-                if (char_iscomment(head))
+                if (!scan.accepts(head))
                     break;
-                if (char_istermchar(head))
-                    break;
-                if (!symbol_next_isvalidnum(symbol, head))
-                    break;
-                if (this->end())
+            }
+
+            return {lineno, column, this->symbol_from(start)};
+        }
+
+        // Parse the body of a string literal, up
+        // to its closing delimiter. The last
+        // symbol parsed is the delimiter that
+        // opened the string.
+        //
+        // Ends where `next_punc` would, but finds
+        // the delimiter with a `memchr` search
+        // rather than testing the source a byte
+        // at a time.
+        TRIPLET(SymbolView) next_string() {
+            uint start  = this->read_head;
+            uint column = this->column();
+            uint lineno = this->lineno();
+            SymbolView open   = this->last_symbol();
+            SymbolView before = this->symbol_ribbon[1];
+            const char* begin = this->data.data();
+            const char* stop  = begin + this->data.length();
+
+            // A body spelled the same as a string
+            // symbol parsed just before the opening
+            // one ends there.
+            if (symbol_isstrsym(before) && this->lookahead(before.length()) == before)
+                stop = begin + start + before.length();
+
+            // Bodies are at least one char long.
+            // Delimiters escaped with '\\' do not
+            // close the string, unless the '\\' is
+            // itself escaped.
+            const char* at = begin + start + 1;
+            while (at < stop) {
+                at = (const char*)std::memchr(at, open[0], stop - at);
+                if (!at) {
+                    at = stop;
                     break;
+                }
+                if (this->data.substr(at - begin, open.length()) == open) {
+                    size_t escapes = 0;
+                    while (at - escapes > begin + start && at[-(ptrdiff_t)escapes - 1] == '\\')
+                        escapes++;
+                    if (escapes % 2 == 0)
+                        break;
+                }
+                at++;
             }
 
+            this->advance_span(simd::span_lines(begin + start, at));
+            SymbolView symbol = this->symbol_from(start);
+            if (symbol_isstrsym(symbol))
+                this->string_parsing = !(this->string_parsing);
+
             return {lineno, column, symbol};
         }
 
         // Parse next punctuation symbol.
-        TRIPLET(Symbol) next_punc() {
-            std::string symbol("");
+        TRIPLET(SymbolView) next_punc() {
+            uint start  = this->read_head;
             uint column = this->column();
             uint lineno = this->lineno();
-            char head = this->head();
+            char head;
+            SymbolView symbol;
 
+            // Only string literals may span lines.
             while (1) {
-                symbol += head;
-                this->advance();
+                if (this->string_parsing)
+                    this->advance();
+                else
+                    this->read_head++;
+                if (this->end())
+                    break;
 
-                head = this->head();
+                head   = this->head();
+                symbol = this->symbol_from(start);
                 if (!this->string_parsing) {
-                    if (char_isnoparse(head))
-                        break;
-                    if (char_iscomment(head))
-                        break;
-                    if (char_isgroupchar(head))
-                        break;
-                    if (char_istermchar(head))
+                    // Whitespace, comments, groupings,
+                    // terminators and names cannot
+                    // exist in punctuation.
+                    if (char_hasclass(head, CHAR_NOPARSE | CHAR_COMMENT | CHAR_GROUP | CHAR_TERM | CHAR_NAME))
                         break;
 
                     // Gratuitious most likely.
                     if (char_isgroupchar(symbol[0]))
                         break;
 
-                    // Names cannot exist in puncutation.
-                    if (!symbol_next_isvalidpunc(symbol, head))
-                        break;
-
                     // String parsing has most likely
                     // started. Valid string tokens
                     // must not contain non-string
@@ -465,7 +799,7 @@ namespace vixen::symbols {
                     if (symbol_isstrsym(symbol) && !char_isstrchar(head))
                         break;
 
-                    if (char_istermchar((char)symbol[0]))
+                    if (char_istermchar(symbol[0]))
                         break;
 
                     // If string parsing, ignore whatever
@@ -485,22 +819,197 @@ namespace vixen::symbols {
                 // openening string sequence.
                 else if (this->symbol_ribbon[1] == symbol && symbol_isstrsym(this->symbol_ribbon[1]))
                     break;
-
-                if (this->end())
-                    break;
             }
 
+            symbol = this->symbol_from(start);
             if (symbol_isstrsym(symbol))
                 this->string_parsing = !(this->string_parsing);
 
             return {lineno, column, symbol};
         }
 
+        // Source this parser reads from.
+        sources::SourceRef source_ref() const {
+            return this->source;
+        }
+
         // Read-only shortcut to if string parsing
         // or not.
         bool string_mode() {
             return this->string_parsing;
         }
+
+        // The next symbol parsed is the body of a
+        // string, unless the string is empty.
+        bool string_isbody() {
+            return this->string_parsing && symbol_isstrsym(this->last_symbol());
+        }
+    };
+
+    // Parses symbols from a file descriptor, or
+    // stdin, a chunk at a time.
+    //
+    // Only a bounded window of the input is held
+    // at once, see `sources::Stream`. Symbols
+    // that run into the end of the window are
+    // rewound and scanned again once more of the
+    // stream has been read, so partial names,
+    // numerics and open string literals carry
+    // across chunk boundaries.
+    //
+    // Symbols are views into the window and are
+    // only valid until the next symbol is parsed.
+    template <typename T>
+    class BasicStreamParser : public BasicSymbolParser<T> {
+    protected:
+        std::shared_ptr<sources::Stream> stream;
+
+    public:
+        // A parser over no input. Its stream reads
+        // from no descriptor, and so is exhausted
+        // on the first read.
+        BasicStreamParser() : BasicStreamParser(-1) {}
+
+        BasicStreamParser(int fd, const std::string& name = "", size_t chunk = STREAM_CHUNK_SIZE) {
+            this->stream = std::make_shared<sources::Stream>(fd, name, chunk);
+            this->source = this->stream;
+            this->file = this->stream->name;
+            this->file_id = sources::source_register(this->source);
+            this->dimension_line = 1;
+            this->last_line_at = 0;
+            this->read_head = 0;
+            this->string_parsing = false;
+            this->refill();
+        }
+
+        // The window belongs to one parser only.
+        BasicStreamParser(const BasicStreamParser&) = delete;
+        BasicStreamParser& operator=(const BasicStreamParser&) = delete;
+        BasicStreamParser(BasicStreamParser&&) = default;
+        BasicStreamParser& operator=(BasicStreamParser&&) = default;
+
+        // Drop text that is no longer needed from
+        // the front of the window and read another
+        // chunk onto its end. Returns false if the
+        // stream is exhausted.
+        bool refill() {
+            const char* base   = this->data.data();
+            size_t      length = this->data.length();
+            uint        keep   = this->read_head;
+
+            // The string parsing rules look back
+            // at the last two symbols, keep those
+            // around too while within a string.
+            for (auto const& symbol : {this->symbol_ribbon[1], this->symbol_ribbon[2]}) {
+                if (!this->string_parsing)
+                    break;
+                if (symbol.data() >= base && symbol.data() < base + length)
+                    keep = std::min(keep, (uint)(symbol.data() - base));
+            }
+
+            this->stream->drop(keep);
+            size_t count = this->stream->fill();
+            this->data = this->stream->view();
+            this->data_base = this->stream->base();
+
+            // Offsets move back along with the
+            // text. `last_line_at` may now point
+            // before the window, which is fine as
+            // columns are computed with unsigned,
+            // wrapping, arithmetic.
+            this->read_head    -= keep;
+            this->last_line_at -= keep;
+            for (auto& symbol : this->symbol_ribbon) {
+                if (symbol.data() >= base + keep && symbol.data() < base + length)
+                    symbol = SymbolView(this->data.data() + (symbol.data() - base - keep), symbol.length());
+                else
+                    symbol = SymbolView();
+            }
+
+            return count > 0;
+        }
+
+        // Skip whitespace and comments, reading
+        // more of the stream whenever the skip
+        // runs into the end of the window.
+        void advance_stream() {
+            while (1) {
+                uint   start = this->read_head;
+                Lineno line  = this->dimension_line;
+                uint   last  = this->last_line_at;
+
+                this->advancew();
+                this->advancec();
+                if (!this->end() || this->stream->exhausted())
+                    return;
+
+                // The run may continue into the next
+                // chunk. Keep everything up to the
+                // last complete line skipped and
+                // rewind the rest; nothing can be
+                // left open at the start of a line.
+                if (this->dimension_line == line) {
+                    this->read_head    = start;
+                    this->last_line_at = last;
+                } else {
+                    this->read_head = this->last_line_at + 1;
+                }
+                this->refill();
+            }
+        }
+
+        // Parse the next symbol as an owned
+        // string.
+        TRIPLET(Symbol) next_raw() {
+            auto const [lineno, column, symbol] = this->next_view();
+            return {lineno, column, Symbol(symbol)};
+        }
+
+        // Parse the next symbol as a view into
+        // the window.
+        TRIPLET(SymbolView) next_view() {
+            this->advance_stream();
+
+            while (1) {
+                uint       start  = this->read_head;
+                Lineno     line   = this->dimension_line;
+                uint       last   = this->last_line_at;
+                bool       string = this->string_parsing;
+                SymbolView ribbon[3] = {
+                    this->symbol_ribbon[0],
+                    this->symbol_ribbon[1],
+                    this->symbol_ribbon[2]};
+
+                auto symbol = BasicSymbolParser<T>::next_view();
+                if (!this->end() || this->stream->exhausted())
+                    return symbol;
+
+                // The symbol ran into the end of the
+                // window, so may continue into the
+                // next chunk. Rewind and scan it
+                // again with more of the stream.
+                this->read_head      = start;
+                this->dimension_line = line;
+                this->last_line_at   = last;
+                this->string_parsing = string;
+                for (int i = 0; i < 3; i++)
+                    this->symbol_ribbon[i] = ribbon[i];
+                this->refill();
+            }
+        }
+
+        // Bytes currently held in memory for this
+        // parser's window and its line index.
+        size_t resident() {
+            return this->stream->resident();
+        }
+
+        // The `errno` of a failed read, after which
+        // the parser ends early, or 0 if the whole
+        // stream has been read so far.
+        int error() const {
+            return this->stream->error();
+        }
     };
 
     // Parses raw symbol metadata from an input.
@@ -512,4 +1021,19 @@ namespace vixen::symbols {
             return BasicSymbolParser<TRIPLET(Symbol)>::next_raw();
         }
     };
+
+    // Parses raw symbol metadata from a stream.
+    class StreamParser : public BasicStreamParser<TRIPLET(Symbol)> {
+    public:
+        StreamParser() : BasicStreamParser<TRIPLET(Symbol)>() {}
+        StreamParser(int fd, const std::string& name = "", size_t chunk = STREAM_CHUNK_SIZE) :
+            BasicStreamParser<TRIPLET(Symbol)>(fd, name, chunk) {}
+
+        TRIPLET(Symbol) next() {
+            return BasicStreamParser<TRIPLET(Symbol)>::next_raw();
+        }
+    };
+
+    static_assert(SymbolParsing<RawParser>);
+    static_assert(SymbolParsing<StreamParser>);
 };
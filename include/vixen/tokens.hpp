@@ -1,6 +1,13 @@
 #pragma once
-#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <span>
+#include <thread>
+#include <vector>
 
+#include "dfa.hpp"
+#include "interner.hpp"
+#include "numerics.hpp"
 #include "symbols.hpp"
 
 #ifndef SIZE_T_MAX
@@ -109,14 +116,23 @@ namespace vixen::tokens {
         CTRLCharEOL
     };
 
-    #define TYPEMAPPER(NAME, TYPE, REPR) {NAME, {TYPE, REPR}}
+    // A token type, its spelling and its name.
+    // Types with no fixed spelling are given a
+    // placeholder, such as '<name>'.
+    struct TokenSpelling {
+        std::string_view spelling;
+        TokenType        type;
+        std::string_view repr;
+    };
+
+    #define TYPEMAPPER(NAME, TYPE, REPR) TokenSpelling{NAME, TYPE, REPR}
     // Unlike the prototype, we are only mapping
     // enumerations that that we can know to be
     // predictable. Such as punctuation, supported
     // operators and keywords.
     // All other token types can be implicitly
     // discerned based on context after parse time.
-    static std::unordered_map<std::string, std::pair<TokenType, std::string>> TokenTypeMapping = {
+    constexpr TokenSpelling TokenSpellings[] = {
         TYPEMAPPER("<error>", TokenType::Error, "Error"),
         TYPEMAPPER("<error:unknown>", TokenType::ErrorUnknown, "ErrorUnknown"),
         TYPEMAPPER("<error:bad_string>", TokenType::ErrorBadString, "ErrorBadString"),
@@ -153,9 +169,11 @@ namespace vixen::tokens {
         TYPEMAPPER("0b%", TokenType::NumBin, "NumBin"),
         TYPEMAPPER("%.%", TokenType::NumFlt, "NumFlt"),
         TYPEMAPPER("0x%", TokenType::NumHex, "NumHex"),
+        TYPEMAPPER("<numeric:integer>", TokenType::NumInt, "NumInt"),
         TYPEMAPPER("%", TokenType::OperModulus, "OperModulus"),
         TYPEMAPPER("0o%", TokenType::NumOct, "NumOct"),
         TYPEMAPPER("<operation>", TokenType::Oper, "Oper"),
+        TYPEMAPPER("<operation:address_of>", TokenType::OperAddressOf, "OperAddressOf"),
         TYPEMAPPER("&", TokenType::OperBtAnd, "OperBtAnd"),
         TYPEMAPPER("?", TokenType::OperAsk, "OperAsk"),
         TYPEMAPPER("=", TokenType::OperAssign, "OperAssign"),
@@ -206,69 +224,392 @@ namespace vixen::tokens {
         TYPEMAPPER("EOL", TokenType::CTRLCharEOL, "CTRLCharEOL")
     };
 
-    TokenType tokens_find_errunk(Symbol _) {
+    constexpr size_t TokenTypeCount = (size_t)TokenType::CTRLCharEOL + 1;
+
+    // Every token type is spelled exactly once
+    // in `TokenSpellings`.
+    constexpr bool tokens_spellings_complete() {
+        std::array<uint, TokenTypeCount> seen{};
+        for (auto const& token : TokenSpellings) {
+            if ((size_t)token.type >= TokenTypeCount)
+                return false;
+            seen[(size_t)token.type]++;
+        }
+        return std::all_of(seen.begin(), seen.end(), [](uint count) { return count == 1; });
+    }
+
+    static_assert(tokens_spellings_complete(), "every TokenType needs exactly one entry in TokenSpellings");
+
+    // Name of every token type, indexed by the
+    // type itself.
+    constexpr std::array<std::string_view, TokenTypeCount> TokenNames = []() {
+        std::array<std::string_view, TokenTypeCount> names{};
+        for (auto const& [spelling, type, repr] : TokenSpellings)
+            names[(size_t)type] = repr;
+        return names;
+    }();
+
+    #define TOKEN_HASH_BUCKETS 64
+    #define TOKEN_HASH_SIZE    256
+
+    // Hash of a symbol's length and its first,
+    // middle and last chars, salted by `seed`.
+    constexpr uint32_t tokens_hash(SymbolView symbol, uint32_t seed) {
+        if (symbol.empty())
+            return 0;
+
+        uint32_t hash = seed ^ (uint32_t)symbol.length();
+        hash = hash * 0x9e3779b1 + (uint8_t)symbol.front();
+        hash = hash * 0x9e3779b1 + (uint8_t)symbol[symbol.length() / 2];
+        hash = hash * 0x9e3779b1 + (uint8_t)symbol.back();
+
+        // Mix so that seeds do more than shift
+        // every hash by the same amount.
+        hash ^= hash >> 15;
+        hash *= 0x2c1b3c6d;
+        hash ^= hash >> 12;
+        return hash;
+    }
+
+    // Perfect hash table over `TokenSpellings`.
+    //
+    // Spellings are first hashed into buckets.
+    // Each bucket has a seed of its own, chosen
+    // so that its spellings hash on into slots
+    // no other spelling uses. Each slot holds the
+    // index of its spelling, plus one, or 0 if
+    // empty.
+    struct TokenHashTable {
+        std::array<uint8_t, TOKEN_HASH_BUCKETS> seeds{};
+        std::array<uint8_t, TOKEN_HASH_SIZE> slots{};
+
+        constexpr uint8_t slot(SymbolView symbol) const {
+            uint8_t seed = this->seeds[tokens_hash(symbol, 0) % TOKEN_HASH_BUCKETS];
+            return this->slots[tokens_hash(symbol, seed) % TOKEN_HASH_SIZE];
+        }
+    };
+
+    constexpr TokenHashTable tokens_hash_init() {
+        constexpr size_t count = std::size(TokenSpellings);
+        static_assert(count < TOKEN_HASH_SIZE, "too many spellings to index");
+
+        TokenHashTable table;
+        std::array<std::array<uint8_t, count>, TOKEN_HASH_BUCKETS> buckets{};
+        std::array<size_t, TOKEN_HASH_BUCKETS> sizes{};
+        for (size_t i = 0; i < count; i++) {
+            size_t bucket = tokens_hash(TokenSpellings[i].spelling, 0) % TOKEN_HASH_BUCKETS;
+            buckets[bucket][sizes[bucket]++] = i;
+        }
+
+        // Place the fullest buckets first, while
+        // most slots are still free.
+        std::array<uint8_t, TOKEN_HASH_BUCKETS> order{};
+        for (size_t b = 0; b < TOKEN_HASH_BUCKETS; b++)
+            order[b] = b;
+        std::sort(order.begin(), order.end(), [&](uint8_t l, uint8_t r) {
+            return sizes[l] > sizes[r];
+        });
+
+        for (uint8_t bucket : order) {
+            uint32_t seed = 1;
+            for (; seed < 256; seed++) {
+                std::array<uint8_t, TOKEN_HASH_SIZE> slots = table.slots;
+                bool placed = true;
+                for (size_t i = 0; placed && i < sizes[bucket]; i++) {
+                    uint8_t& slot = slots[tokens_hash(TokenSpellings[buckets[bucket][i]].spelling, seed) % TOKEN_HASH_SIZE];
+                    placed = slot == 0;
+                    slot   = buckets[bucket][i] + 1;
+                }
+                if (placed) {
+                    table.slots = slots;
+                    break;
+                }
+            }
+            if (seed == 256)
+                throw "no perfect hash for token spellings";
+            table.seeds[bucket] = seed;
+        }
+        return table;
+    }
+
+    constexpr TokenHashTable TokenHashes = tokens_hash_init();
+
+    // Entry of `TokenSpellings` spelled exactly as
+    // `symbol`, if any. Costs one hash and at most
+    // one compare.
+    constexpr const TokenSpelling* tokens_find_spelling(SymbolView symbol) {
+        uint8_t slot = TokenHashes.slot(symbol);
+        if (!slot || TokenSpellings[slot - 1].spelling != symbol)
+            return nullptr;
+        return &TokenSpellings[slot - 1];
+    }
+
+    // Spelling can be lexed as is. Placeholders,
+    // such as '<name>' and '0x%', cannot.
+    constexpr bool tokens_islexable(std::string_view spelling) {
+        if (spelling.length() > 2 && spelling.front() == '<' && spelling.back() == '>')
+            return false;
+        return spelling == "%" || spelling.find('%') == std::string_view::npos;
+    }
+
+    // Build the automaton `Lexer` scans with when
+    // constructed with `LexerKind::Dfa`.
+    //
+    // Names and numerics are described by hand,
+    // every lexable spelling in `TokenSpellings`
+    // is then laid over them. Scanning with the
+    // longest match accepted classifies a token
+    // in the same pass that finds its end.
+    constexpr dfa::Automaton tokens_automaton_init() {
+        constexpr std::string_view digits  = "0123456789";
+        constexpr std::string_view hexits  = "0123456789abcdefABCDEF_";
+        constexpr std::string_view letters =
+            "abcdefghijklmnopqrstuvwxyz"
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+            "_";
+        dfa::Automaton automaton;
+
+        // Every set of bytes linked on below must
+        // be told apart first.
+        automaton.distinguish(letters);
+        automaton.distinguish(digits);
+        automaton.distinguish(hexits);
+        automaton.distinguish("01234567");
+        automaton.distinguish("01");
+        automaton.distinguish_each("0._xdbo");
+        for (auto const& token : TokenSpellings) {
+            if (tokens_islexable(token.spelling))
+                automaton.distinguish_each(token.spelling);
+        }
+
+        // Names.
+        dfa::State name = automaton.state((dfa::Accept)TokenType::NameGeneric);
+        automaton.link(dfa::START, letters, name);
+        automaton.link(name, letters, name);
+        automaton.link(name, digits, name);
+
+        // Numerics, with optional base notation and
+        // '_' separators.
+        dfa::State zero = automaton.state((dfa::Accept)TokenType::NumInt);
+        dfa::State dec  = automaton.state((dfa::Accept)TokenType::NumInt);
+        dfa::State flt  = automaton.state((dfa::Accept)TokenType::NumFlt);
+        dfa::State hex  = automaton.state((dfa::Accept)TokenType::NumHex);
+        dfa::State bin  = automaton.state((dfa::Accept)TokenType::NumBin);
+        dfa::State oct  = automaton.state((dfa::Accept)TokenType::NumOct);
+        dfa::State based[4] = {
+            automaton.state(),
+            automaton.state(),
+            automaton.state(),
+            automaton.state()};
+
+        automaton.link(dfa::START, digits, dec);
+        automaton.link(dfa::START, "0", zero);
+        for (dfa::State from : {zero, dec}) {
+            automaton.link(from, digits, dec);
+            automaton.link(from, "_", dec);
+            automaton.link(from, ".", flt);
+        }
+        automaton.link(flt, digits, flt);
+        automaton.link(flt, "_", flt);
+
+        automaton.link(zero, "x", based[0]);
+        automaton.link(zero, "b", based[1]);
+        automaton.link(zero, "o", based[2]);
+        automaton.link(zero, "d", based[3]);
+        automaton.link(based[0], hexits, hex);
+        automaton.link(hex, hexits, hex);
+        automaton.link(based[1], "01_", bin);
+        automaton.link(bin, "01_", bin);
+        automaton.link(based[2], "01234567_", oct);
+        automaton.link(oct, "01234567_", oct);
+        automaton.link(based[3], digits, dec);
+        automaton.link(based[3], "_", dec);
+
+        // Keywords, operators, punctuation and
+        // string delimiters.
+        for (auto const& token : TokenSpellings) {
+            if (tokens_islexable(token.spelling))
+                automaton.add({token.spelling, (dfa::Accept)token.type});
+        }
+
+        // Floats may lead with '.'.
+        automaton.link(automaton.walk("."), digits, flt);
+        return automaton;
+    }
+
+    constexpr dfa::Automaton TokenAutomaton = tokens_automaton_init();
+
+    TokenType tokens_find_errunk(SymbolView _) {
         return TokenType::ErrorUnknown;
     }
 
-    std::string tokens_find_genname(Symbol symbol) {
-        if (!TokenTypeMapping.contains(symbol))
+    constexpr std::string_view tokens_find_genname(SymbolView symbol) {
+        const TokenSpelling* found = tokens_find_spelling(symbol);
+        if (!found)
             return "NameGeneric";
-        return TokenTypeMapping[symbol].second;
+        return found->repr;
     }
 
-    std::string tokens_find_genname(TokenType type) {
-        for (const auto& [key, value] : TokenTypeMapping) {
-            if (value.first == type)
-                return value.second;
-        }
-        return "ErrorUnknown";
+    constexpr std::string_view tokens_find_genname(TokenType type) {
+        if ((size_t)type >= TokenTypeCount)
+            return "ErrorUnknown";
+        return TokenNames[(size_t)type];
     }
 
-    TokenType tokens_find_gentype(Symbol symbol) {
-        if (!TokenTypeMapping.contains(symbol))
+    constexpr TokenType tokens_find_gentype(SymbolView symbol) {
+        const TokenSpelling* found = tokens_find_spelling(symbol);
+        if (!found)
             return TokenType::NameGeneric;
-        return TokenTypeMapping[symbol].first;
+        return found->type;
+    }
+
+    TokenType tokens_find_numtype(NumericKind kind) {
+        switch (kind) {
+            case NUMERIC_BIN: return TokenType::NumBin;
+            case NUMERIC_FLT: return TokenType::NumFlt;
+            case NUMERIC_HEX: return TokenType::NumHex;
+            case NUMERIC_OCT: return TokenType::NumOct;
+            default:          return TokenType::NumInt;
+        }
+    }
+
+    TokenType tokens_find_numtype(SymbolView symbol) {
+        return tokens_find_numtype(NumericScan(symbol).kind());
     }
 
-    TokenType tokens_find_numtype(Symbol symbol) {
-        if (symbol.find("0b") != SIZE_T_MAX)
-            return TokenType::NumBin;
-        if (symbol.find(".") != SIZE_T_MAX)
-            return TokenType::NumFlt;
-        if (symbol.find("0x") != SIZE_T_MAX)
-            return TokenType::NumHex;
-        if (symbol.find("0o") != SIZE_T_MAX)
-            return TokenType::NumOct;
-
-        return TokenType::NumInt;
+    // Token type is one of the numeric types.
+    constexpr bool tokens_isnumeric(TokenType type) {
+        return type > TokenType::Num && type <= TokenType::NumOct;
     }
 
+    constexpr NumericKind tokens_find_numkind(TokenType type) {
+        switch (type) {
+            case TokenType::NumBin: return NUMERIC_BIN;
+            case TokenType::NumFlt: return NUMERIC_FLT;
+            case TokenType::NumHex: return NUMERIC_HEX;
+            case TokenType::NumOct: return NUMERIC_OCT;
+            default:                return NUMERIC_INT;
+        }
+    }
+
+    // Tokens of this type are interned: names
+    // and keywords, the symbols compared by
+    // their text. Literals and punctuation are
+    // not, so the interner only grows with the
+    // names a program uses.
+    constexpr bool tokens_isinterned(TokenType type) {
+        return type == TokenType::NameGeneric || (type > TokenType::Kwd && type <= TokenType::KwdWith);
+    }
+
+    // Type of the token a symbol lexes to.
+    TokenType tokens_classify(SymbolView symbol) {
+        NumericScan scan(symbol);
+        if (scan.isnumeric())
+            return tokens_find_numtype(scan.kind());
+        return tokens_find_gentype(symbol);
+    }
+
+    // A classified symbol.
+    //
+    // Tokens do not own their text. `symbol` is a
+    // view into the source the token was lexed
+    // from, and is only valid for as long as that
+    // source is.
+    //
+    // Positions are kept as a byte offset and the
+    // id of the source. Line numbers and columns
+    // are only worked out when asked for, which
+    // is rarely outside of diagnostics.
     class Token {
         public:
-            Symbol      symbol;
-            TokenType   type;
-            Lineno      lineno;
-            Column      column;
-            std::string file;
+            SymbolView        symbol;
+            TokenType         type;
+            sources::Offset   offset  = 0;
+            // Interned id of `symbol`, see
+            // `interner::interner_global`. Names and
+            // keywords with equal symbols have equal
+            // ids, other tokens have id 0. See
+            // `tokens_isinterned`.
+            interner::SymbolId id = 0;
+            sources::FileId   file_id = 0;
 
         public:
             Token() {}
 
+            // Token of a known type.
             Token(
-                Lineno lineno,
-                Column column,
-                Symbol symbol,
-                std::string file = "") {
-
-                this->lineno = lineno;
-                this->column = column;
-                this->symbol = symbol;
-                this->file   = file;
-
-                if (symbol_isnumeric(symbol))
-                    this->type = tokens_find_numtype(symbol);
-                else
-                    this->type = tokens_find_gentype(symbol);
+                SymbolView symbol,
+                TokenType type,
+                sources::Offset offset = 0,
+                sources::FileId file_id = 0) {
+
+                this->symbol  = symbol;
+                this->type    = type;
+                this->offset  = offset;
+                this->file_id = file_id;
+                if (tokens_isinterned(type))
+                    this->id = interner::interner_global().intern(symbol);
+            }
+
+            // Token whose symbol was interned
+            // already, as `id`.
+            Token(
+                SymbolView symbol,
+                TokenType type,
+                sources::Offset offset,
+                sources::FileId file_id,
+                interner::SymbolId id) {
+
+                this->symbol  = symbol;
+                this->type    = type;
+                this->offset  = offset;
+                this->file_id = file_id;
+                this->id      = id;
+            }
+
+            Token(
+                SymbolView symbol,
+                sources::Offset offset = 0,
+                sources::FileId file_id = 0) : Token(symbol, tokens_classify(symbol), offset, file_id) {}
+
+            // Source this token was lexed from, or
+            // `nullptr` if it has been released.
+            // Each lookup takes the registry's lock,
+            // so look it up once to read several
+            // positions.
+            sources::SourceRef source() const {
+                return sources::source_lookup(this->file_id);
+            }
+
+            // Line number and column of this
+            // token. Both are 0 if its source has
+            // been released.
+            sources::Location location() const {
+                return this->location(this->source());
+            }
+
+            // As above, within the token's `source`.
+            sources::Location location(const sources::SourceRef& source) const {
+                if (!source)
+                    return {0, 0};
+                return source->locate(this->offset);
+            }
+
+            Lineno lineno() const {
+                return this->location().first;
+            }
+
+            Column column() const {
+                return this->location().second;
+            }
+
+            // Name of the file this token was lexed
+            // from, if any.
+            std::string file() const {
+                sources::SourceRef source = this->source();
+                if (!source)
+                    return "";
+                return source->name;
             }
         private:
             friend std::ostream& operator<<(std::ostream& os, const Token& token) {
@@ -278,17 +619,26 @@ namespace vixen::tokens {
                 else
                     os << "[\"" << token.symbol << "\"]";
 
+                sources::SourceRef source = token.source();
+                auto const [lineno, column] = token.location(source);
+
                 os << "@(";
-                os << "lineno: " << token.lineno << ", ";
-                os << "column: " << token.column;
-                if (token.file.length() > 0)
-                    os << ", file: '" << token.file << "'";
+                os << "lineno: " << lineno << ", ";
+                os << "column: " << column;
+                if (source && source->name.length() > 0)
+                    os << ", file: '" << source->name << "'";
                 os << ")";
 
                 return os;
             }
     };
 
+    // Type of the token lexed at the end of
+    // input.
+    constexpr bool tokens_isend(TokenType type) {
+        return type == TokenType::CTRLCharEOF || type == TokenType::CTRLCharEOL;
+    }
+
     bool tokens_isfloat(Token token) {
         return token.type == TokenType::NumFlt;
     }
@@ -312,21 +662,615 @@ namespace vixen::tokens {
         return false;
     }
 
+    // Default number of tokens lexed at a time
+    // by batch consumers.
+    #define TOKEN_BATCH_SIZE 256
+
+    // How a `Lexer` finds and classifies tokens.
+    enum class LexerKind {
+        // Find symbols with the symbol parser,
+        // then classify them.
+        Symbols,
+        // Find and classify tokens together with
+        // `TokenAutomaton`, taking the longest
+        // spelling the token table knows at each
+        // point. The symbol parser instead splits
+        // input into runs of like chars and
+        // classifies each run whole, so the two
+        // differ where runs are not spellings:
+        //
+        // - A run of punctuation, string
+        //   delimiters included, is one symbol to
+        //   the symbol parser, a `NameGeneric` if
+        //   no token is spelled so: '|=', '!=',
+        //   '**-', '*"', '""'. Here it is split
+        //   into the spellings it starts with.
+        // - Bytes no spelling starts with, such as
+        //   '$', are `ErrorUnknown` here, one byte
+        //   at a time.
+        // - A numeric runs on through name chars
+        //   and is classified whole: '0a', '9w' and
+        //   '1.5w' are names, '1x' an integer, and
+        //   '0x1fb' a name as its 'b' is taken for
+        //   a binary notation. Here the longest
+        //   numeric is taken ('0x1fb' is hex) and
+        //   what follows lexed on its own.
+        // - '-' never leads a numeric here.
+        // - Names of only digits, '_' and the
+        //   notation chars 'b', 'd', 'o' and 'x',
+        //   such as 'x0', are numerics to the
+        //   symbol parser and names here.
+        //
+        // Otherwise, strings included, both lex the
+        // same.
+        Dfa
+    };
+
+    // Tokens lexed from a whole source. Symbols
+    // are views into the source, so it is held
+    // along with them; tokens copied out of the
+    // list are only valid while it, or some
+    // other reference to the source, is.
+    struct TokenList {
+        sources::SourceRef source;
+        std::vector<Token> tokens;
+    };
+
     class Lexer : public BasicSymbolParser<Token> {
+        private:
+            LexerKind kind = LexerKind::Symbols;
+            // Delimiter of the string being lexed.
+            SymbolView string_open;
+
+            // End of input token. EOL if no line
+            // has been ended, otherwise EOF.
+            Token next_end() {
+                SymbolView symbol = this->lineno() > 1 ? "EOF" : "EOL";
+                return Token(symbol, this->offset_of(symbol), this->file_id);
+            }
+
+            // Lex the next token with `TokenAutomaton`.
+            Token next_dfa() {
+                this->advancew();
+                this->advancec();
+                if (this->end())
+                    return this->next_end();
+                if (this->string_parsing)
+                    return this->next_dfa_string();
+
+                // Run the automaton as far as it will
+                // go, remembering the last accepting
+                // state passed. That state's token is
+                // the longest match.
+                const char* bytes    = this->data.data();
+                uint        length   = this->data.length();
+                uint        at       = this->read_head;
+                uint        stop     = this->read_head + 1;
+                dfa::Accept accepted = (dfa::Accept)TokenType::ErrorUnknown;
+                dfa::State  state    = dfa::START;
+
+                while (at < length) {
+                    state = TokenAutomaton.step(state, bytes[at++]);
+                    if (state == dfa::DEAD)
+                        break;
+                    if (TokenAutomaton.accept(state) != DFA_REJECT) {
+                        accepted = TokenAutomaton.accept(state);
+                        stop     = at;
+                    }
+                }
+
+                SymbolView symbol = this->symbol_from_to(this->read_head, stop);
+                TokenType  type   = (TokenType)accepted;
+                if (type >= TokenType::StrSingleBkt && type <= TokenType::StrTripleSgl) {
+                    this->string_parsing = true;
+                    this->string_open    = symbol;
+                }
+
+                Token token(symbol, type, this->offset_of(symbol), this->file_id);
+                this->read_head = stop;
+                return token;
+            }
+
+            // Lex the body of a string, or its
+            // closing delimiter. Delimiters escaped
+            // with '\\' do not close a string.
+            Token next_dfa_string() {
+                size_t close = this->read_head;
+                while (1) {
+                    close = this->data.find(this->string_open, close);
+                    if (close == SymbolView::npos) {
+                        close = this->data.length();
+                        break;
+                    }
+
+                    size_t escapes = 0;
+                    while (close - escapes > this->read_head && this->data[close - escapes - 1] == '\\')
+                        escapes++;
+                    if (escapes % 2 == 0)
+                        break;
+                    close++;
+                }
+
+                SymbolView symbol;
+                TokenType  type;
+                if (close == this->read_head) {
+                    symbol = this->symbol_from_to(close, close + this->string_open.length());
+                    type   = tokens_find_gentype(symbol);
+                    this->string_parsing = false;
+                } else {
+                    symbol = this->symbol_from_to(this->read_head, close);
+                    type   = TokenType::StrExpression;
+                }
+
+                // Bodies may span lines, which are
+                // counted as they are passed over.
+                Token token(symbol, type, this->offset_of(symbol), this->file_id);
+                this->advance_span(simd::span_lines(symbol.data(), symbol.data() + symbol.length()));
+                return token;
+            }
+
+            SymbolView symbol_from_to(uint start, uint stop) {
+                return this->data.substr(start, stop - start);
+            }
+
         public:
             BasicSymbolParser__init__(Lexer, Token)
 
+            Lexer(sources::SourceRef source, LexerKind kind) : Lexer(source) {
+                this->kind = kind;
+            }
+
             Token next() {
-                Lineno lineno;
-                Column column;
-                Symbol symbol;
+                if (this->kind == LexerKind::Dfa)
+                    return this->next_dfa();
+
+                bool body = this->string_isbody();
+                auto const [lineno, column, symbol] = BasicSymbolParser<Token>::next_view();
+                if (body && !symbol_isstrsym(symbol) && !this->symbol_isend(symbol))
+                    return Token(symbol, TokenType::StrExpression, this->offset_of(symbol), this->file_id);
+                return Token(symbol, this->offset_of(symbol), this->file_id);
+            }
+
+            // Lex tokens into a caller owned
+            // buffer, so one call does the work of
+            // many calls to `next`. The buffer is
+            // filled unless the end of input is
+            // reached first, in which case the
+            // last token lexed is EOF or EOL.
+            // Returns the number of tokens lexed.
+            size_t next_batch(std::span<Token> buffer) {
+                size_t count = 0;
+                while (count < buffer.size()) {
+                    Token& token = buffer[count++];
+                    token = this->next();
+                    if (this->symbol_isend(token.symbol))
+                        break;
+                }
+                return count;
+            }
+
+            // Lex the rest of the input into one
+            // contiguous vector, ending with a
+            // single EOF or EOL token.
+            TokenList tokenize_all() {
+                TokenList list{this->source, {}};
+                std::vector<Token>& tokens = list.tokens;
+
+                // Most symbols are short; guess at
+                // one token per four bytes to keep
+                // regrowth rare.
+                tokens.reserve((this->data.length() - this->read_head) / 4 + 1);
+                while (tokens.empty() || !this->symbol_isend(tokens.back().symbol)) {
+                    size_t at = tokens.size();
+                    tokens.resize(at + TOKEN_BATCH_SIZE);
+                    tokens.resize(at + this->next_batch(std::span<Token>(tokens).subspan(at)));
+                }
+                return list;
+            }
+    };
+
+    // Lex a whole source into one contiguous
+    // vector of tokens.
+    TokenList tokenize_all(sources::SourceRef source) {
+        return Lexer(source).tokenize_all();
+    }
+
+    // Smallest slice of input worth handing to a
+    // thread of its own.
+    #define TOKEN_SLICE_MIN (1 << 20)
+
+    // A slice of input lexed on a worker thread,
+    // assuming it does not start within a
+    // string literal.
+    struct LexSlice {
+        Lexer lexer;
+        std::vector<Token> tokens;
+        // Offset of the first symbol, past any
+        // leading whitespace and comments.
+        uint first;
+        uint end;
+    };
+
+    // Lex tokens until the next symbol starts at
+    // or beyond `end`, leaving the read head on
+    // that symbol.
+    void tokens_lex_until(Lexer& lexer, uint end, std::vector<Token>& tokens) {
+        while (1) {
+            lexer.advancew();
+            lexer.advancec();
+            if (lexer.end() || lexer.position() >= end)
+                return;
+            tokens.push_back(lexer.next());
+        }
+    }
+
+    // A slice lexed speculatively picks up from
+    // where `lexer` left off. That holds only if
+    // the two meet on the same symbol outside of
+    // a string, and the slice does not open with
+    // a string; the rules for closing a string
+    // look back at the symbol before it opened.
+    bool tokens_slice_follows(Lexer& lexer, LexSlice& slice) {
+        if (lexer.string_mode() || lexer.position() != slice.first)
+            return false;
+        return slice.tokens.empty() || !symbol_isstrsym(slice.tokens.front().symbol);
+    }
+
+    // Lex a whole source into one contiguous
+    // vector of tokens, across up to `threads`
+    // threads. Tokens are identical to those of
+    // `tokenize_all`.
+    //
+    // The source is split at line boundaries and
+    // each slice is lexed as if it did not start
+    // within a string. Slices are then stitched
+    // together in order; where a string literal
+    // does cross into a slice, the lexer of the
+    // slice before carries on through it instead.
+    // Line numbers need no fixing up, as tokens
+    // only record their offset.
+    TokenList tokenize_parallel(
+        sources::SourceRef source,
+        size_t threads = 0,
+        size_t slice_min = TOKEN_SLICE_MIN) {
+
+        std::string_view data = source->view();
+        if (!threads)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = std::min(threads, data.length() / std::max(slice_min, (size_t)1));
+        if (threads < 2)
+            return tokenize_all(source);
+
+        // Split roughly evenly, moving each
+        // boundary forward onto the start of a
+        // line.
+        std::vector<uint> bounds = {0};
+        for (size_t i = 1; i < threads; i++) {
+            const char* at = simd::skip_line(
+                data.data() + std::max((size_t)bounds.back(), data.length() * i / threads),
+                data.data() + data.length());
+            if (at == data.data() + data.length())
+                break;
+            bounds.push_back(at - data.data() + 1);
+        }
+        bounds.push_back(data.length());
+
+        std::vector<LexSlice> slices(bounds.size() - 1);
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < slices.size(); i++) {
+            workers.emplace_back([&, i]() {
+                LexSlice& slice = slices[i];
+                slice.lexer = Lexer(source);
+                slice.lexer.seek(bounds[i]);
+                slice.lexer.advancew();
+                slice.lexer.advancec();
+                slice.first = slice.lexer.position();
+                slice.end   = bounds[i + 1];
+                slice.tokens.reserve((slice.end - bounds[i]) / 4 + 1);
+                tokens_lex_until(slice.lexer, slice.end, slice.tokens);
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+
+        TokenList list{source, {}};
+        std::vector<Token>& tokens = list.tokens;
+        size_t total = 1;
+        for (auto const& slice : slices)
+            total += slice.tokens.size();
+        tokens.reserve(total);
+
+        Lexer* lexer = &slices[0].lexer;
+        tokens.insert(tokens.end(), slices[0].tokens.begin(), slices[0].tokens.end());
+        for (size_t i = 1; i < slices.size(); i++) {
+            if (tokens_slice_follows(*lexer, slices[i])) {
+                lexer = &slices[i].lexer;
+                tokens.insert(tokens.end(), slices[i].tokens.begin(), slices[i].tokens.end());
+            } else {
+                tokens_lex_until(*lexer, slices[i].end, tokens);
+            }
+        }
+
+        tokens.push_back(lexer->next());
+        return list;
+    }
+
+    // Decode the values of every numeric token
+    // in `tokens`, addressed by index.
+    numerics::NumericTable tokens_decode_numerics(std::span<const Token> tokens) {
+        numerics::NumericTable table;
+        for (size_t i = 0; i < tokens.size(); i++) {
+            if (tokens_isnumeric(tokens[i].type))
+                table.add(i, numerics::numeric_decode(tokens[i].symbol, tokens_find_numkind(tokens[i].type)));
+        }
+        return table;
+    }
+
+    static_assert(TokenTypeCount <= 256, "token types must fit in a byte");
+
+    // A whole source's tokens, kept as parallel
+    // arrays rather than as a vector of `Token`.
+    //
+    // Each token costs 13 bytes: its type, the
+    // offset of its symbol, the symbol's length
+    // and its interned id. The source, and the
+    // file id it is registered under, are shared
+    // by every token. Scanning types, as a parser
+    // mostly does, touches one byte per token.
+    //
+    // `Token`s are only built when asked for,
+    // see `token`, and without going back to the
+    // interner. Numeric tokens are decoded as
+    // they are pushed and their values kept to
+    // the side, see `numeric`.
+    class TokenStream {
+        private:
+            sources::SourceRef source;
+            sources::FileId    file_id = 0;
+            std::span<const uint8_t>         types;
+            std::span<const sources::Offset> offsets;
+            std::span<const uint32_t>        lengths;
+            // Interned ids are only meaningful to
+            // this process, so are never cached.
+            std::vector<interner::SymbolId>  ids;
+            numerics::NumericTable           numerics;
+            // Arrays of tokens pushed onto this
+            // stream. Streams loaded from a cache
+            // view the cache's mapping instead, see
+            // `storage`.
+            std::vector<uint8_t>         type_store;
+            std::vector<sources::Offset> offset_store;
+            std::vector<uint32_t>        length_store;
+            sources::SourceRef           storage;
+
+            // Point the arrays at the stores.
+            void bind() {
+                this->types   = this->type_store;
+                this->offsets = this->offset_store;
+                this->lengths = this->length_store;
+            }
+
+        public:
+            // Position within a stream. Cheap to copy,
+            // so positions can be saved and returned
+            // to freely. Moving past the last token,
+            // EOF or EOL, stays on it.
+            class Cursor {
+                private:
+                    const TokenStream* stream = nullptr;
+                    size_t index = 0;
+
+                public:
+                    Cursor() {}
+                    Cursor(const TokenStream* stream, size_t index = 0) {
+                        this->stream = stream;
+                        this->index  = std::min(index, std::max(stream->size(), (size_t)1) - 1);
+                    }
+
+                    // The last token has been reached.
+                    bool done() const {
+                        return this->index + 1 >= this->stream->size();
+                    }
+
+                    // Cursor `count` tokens further on.
+                    Cursor peek(size_t count = 1) const {
+                        return Cursor(this->stream, this->index + count);
+                    }
+
+                    size_t position() const {
+                        return this->index;
+                    }
 
-                std::tie(
-                    lineno,
-                    column,
-                    symbol) = BasicSymbolParser<Token>::next_raw();
+                    void advance(size_t count = 1) {
+                        *this = this->peek(count);
+                    }
 
-                return Token(lineno, column, symbol, this->file);
+                    TokenType type() const {
+                        return this->stream->type(this->index);
+                    }
+
+                    SymbolView symbol() const {
+                        return this->stream->symbol(this->index);
+                    }
+
+                    sources::Offset offset() const {
+                        return this->stream->offset(this->index);
+                    }
+
+                    Token token() const {
+                        return this->stream->token(this->index);
+                    }
+
+                    const numerics::NumericValue* numeric() const {
+                        return this->stream->numeric(this->index);
+                    }
+            };
+
+            TokenStream() {}
+
+            // Views, not copies, are handed out of
+            // a stream's arrays; streams may only
+            // be moved.
+            TokenStream(const TokenStream&) = delete;
+            TokenStream& operator=(const TokenStream&) = delete;
+            TokenStream(TokenStream&&) = default;
+            TokenStream& operator=(TokenStream&&) = default;
+
+            // Tokens of `source` held in arrays
+            // within `storage`, such as a mapped
+            // token cache. Names and keywords are
+            // interned, and numerics decoded, again
+            // from the source.
+            TokenStream(
+                sources::SourceRef source,
+                sources::SourceRef storage,
+                std::span<const uint8_t> types,
+                std::span<const sources::Offset> offsets,
+                std::span<const uint32_t> lengths) {
+
+                this->source  = source;
+                this->file_id = sources::source_register(source);
+                this->storage = storage;
+                this->types   = types;
+                this->offsets = offsets;
+                this->lengths = lengths;
+                this->ids.resize(this->size());
+                for (size_t i = 0; i < this->size(); i++) {
+                    TokenType type = this->type(i);
+                    if (tokens_isnumeric(type))
+                        this->numerics.add(i, numerics::numeric_decode(this->symbol(i), tokens_find_numkind(type)));
+                    if (tokens_isinterned(type))
+                        this->ids[i] = interner::interner_global().intern(this->symbol(i));
+                }
+            }
+
+            // Lex the whole of `source`.
+            TokenStream(sources::SourceRef source) {
+                Lexer lexer(source);
+                std::vector<Token> batch(TOKEN_BATCH_SIZE);
+
+                this->source  = source;
+                this->file_id = sources::source_register(source);
+                this->reserve(source->view().length() / 4 + 1);
+                while (1) {
+                    size_t count = lexer.next_batch(batch);
+                    for (size_t i = 0; i < count; i++)
+                        this->push(batch[i], lexer.symbol_isend(batch[i].symbol));
+                    if (!count || lexer.symbol_isend(batch[count - 1].symbol))
+                        break;
+                }
+
+                // The guess reserved above is
+                // usually generous.
+                this->type_store.shrink_to_fit();
+                this->offset_store.shrink_to_fit();
+                this->length_store.shrink_to_fit();
+                this->ids.shrink_to_fit();
+                this->bind();
+            }
+
+            // Append a token lexed from this stream's
+            // source. End markers, EOF and EOL, have
+            // no text in the source and are kept with
+            // a length of 0.
+            void push(const Token& token, bool end = false) {
+                if (tokens_isnumeric(token.type))
+                    this->numerics.add(this->size(), numerics::numeric_decode(token.symbol, tokens_find_numkind(token.type)));
+                this->type_store.push_back((uint8_t)token.type);
+                this->offset_store.push_back(token.offset);
+                this->length_store.push_back(end ? 0 : token.symbol.length());
+                this->ids.push_back(token.id);
+                this->bind();
+            }
+
+            void reserve(size_t count) {
+                this->type_store.reserve(count);
+                this->offset_store.reserve(count);
+                this->length_store.reserve(count);
+                this->ids.reserve(count);
+            }
+
+            // Bytes held for tokens, not counting
+            // numeric values.
+            size_t bytes() const {
+                return this->types.size_bytes()
+                    + this->offsets.size_bytes()
+                    + this->lengths.size_bytes()
+                    + this->ids.size() * sizeof(interner::SymbolId);
+            }
+
+            // Arrays of every token's type, offset
+            // and symbol length, in order.
+            std::span<const uint8_t> type_array() const {
+                return this->types;
+            }
+
+            std::span<const sources::Offset> offset_array() const {
+                return this->offsets;
+            }
+
+            std::span<const uint32_t> length_array() const {
+                return this->lengths;
+            }
+
+            // Source the tokens were lexed from.
+            sources::SourceRef source_ref() const {
+                return this->source;
+            }
+
+            // Decoded value of the token at `index`,
+            // or `nullptr` if it is not numeric.
+            const numerics::NumericValue* numeric(size_t index) const {
+                return this->numerics.find(index);
+            }
+
+            Cursor cursor(size_t index = 0) const {
+                return Cursor(this, index);
+            }
+
+            bool empty() const {
+                return this->types.empty();
+            }
+
+            size_t size() const {
+                return this->types.size();
+            }
+
+            TokenType type(size_t index) const {
+                return (TokenType)this->types[index];
+            }
+
+            sources::Offset offset(size_t index) const {
+                return this->offsets[index];
+            }
+
+            SymbolView symbol(size_t index) const {
+                if (!this->lengths[index] && tokens_isend(this->type(index)))
+                    return this->type(index) == TokenType::CTRLCharEOF ? "EOF" : "EOL";
+                return this->source->view().substr(this->offsets[index], this->lengths[index]);
+            }
+
+            Token token(size_t index) const {
+                return Token(this->symbol(index), this->type(index), this->offset(index), this->file_id, this->ids[index]);
+            }
+    };
+
+    // Lexes tokens from a file descriptor, or
+    // stdin, a chunk at a time. See
+    // `BasicStreamParser`; tokens are only valid
+    // until the next token is lexed.
+    class StreamLexer : public BasicStreamParser<Token> {
+        public:
+            StreamLexer() : BasicStreamParser<Token>() {}
+            StreamLexer(int fd, const std::string& name = "", size_t chunk = STREAM_CHUNK_SIZE) :
+                BasicStreamParser<Token>(fd, name, chunk) {}
+
+            Token next() {
+                bool body = this->string_isbody();
+                auto const [lineno, column, symbol] = BasicStreamParser<Token>::next_view();
+                if (body && !symbol_isstrsym(symbol) && !this->symbol_isend(symbol))
+                    return Token(symbol, TokenType::StrExpression, this->offset_of(symbol), this->file_id);
+                return Token(symbol, this->offset_of(symbol), this->file_id);
             }
     };
 };
\ No newline at end of file
@@ -7,9 +7,12 @@
 // Adapted from original test_testconf.hpp, this header file defines
 // tools Vixen uses to test its internal API.
 #pragma once
+#include <atomic>
+#include <cstdlib>
 #include <format>
 #include <iomanip>
 #include <iostream>
+#include <new>
 #include <unordered_map>
 #include <vector>
 
@@ -21,6 +24,15 @@
 namespace hounddog {
     typedef void(*TestCaseFunc)(void);
 
+    // Number of heap allocations made by this
+    // process so far. Lets tests assert that hot
+    // paths do not allocate.
+    static std::atomic<size_t> allocations_made = 0;
+
+    size_t allocations() {
+        return allocations_made;
+    }
+
     // Test runtime statistics.
     struct TestRunStats {
         std::unordered_map<std::string, TestCaseFunc> registry;
@@ -228,3 +240,23 @@ namespace hounddog {
             trs.registry.size());
     }
 }
+
+// Replace global allocation to count allocations
+// made; see `hounddog::allocations`.
+__attribute__((noinline))
+void* operator new(size_t size) {
+    hounddog::allocations_made.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline))
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+__attribute__((noinline))
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
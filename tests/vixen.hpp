@@ -1,2 +1,10 @@
 #include "vixen/test_symbols.hpp"
 #include "vixen/test_tokens.hpp"
+#include "vixen/test_simd.hpp"
+#include "vixen/test_sources.hpp"
+#include "vixen/test_parser.hpp"
+#include "vixen/test_interner.hpp"
+#include "vixen/test_dfa.hpp"
+#include "vixen/test_numerics.hpp"
+#include "vixen/test_cache.hpp"
+#include "vixen/test_incremental.hpp"
@@ -0,0 +1,62 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "tests/hounddog.hpp"
+#include "include/vixen/cache.hpp"
+
+namespace test_vixen::cache {
+    using namespace vixen::cache;
+
+    const std::string cache_name("/tmp/vixen_test_cache.vxt");
+
+    vixen::sources::SourceRef setup_source(std::string data = "") {
+        if (!data.length()) {
+            for (int i = 0; i < 256; i++)
+                data += "x: int = 0x_ff + y * (z - 1.5); # comment\ns = \"a\nstring\";\n";
+        }
+        return vixen::sources::source_from_string(data);
+    }
+
+    void test_cache_roundtrip() {
+        auto source = setup_source();
+        TokenStream expected(source);
+        hounddog::assert(cache_write(expected, cache_name), "Cache should be written.");
+
+        auto loaded = cache_load(source, cache_name);
+        hounddog::assert(loaded != nullptr, "Cache should load for the text it was written for.");
+        hounddog::assert(loaded->size() == expected.size(), "Expected {} tokens got {}", expected.size(), loaded->size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            Token ex = expected.token(i);
+            Token pr = loaded->token(i);
+            hounddog::assert(
+                ex.symbol == pr.symbol && ex.type == pr.type && ex.offset == pr.offset && ex.id == pr.id,
+                "Expected '{}' at {} got '{}' at {}", ex.symbol, ex.offset, pr.symbol, pr.offset);
+        }
+        hounddog::assert(loaded->numeric(4)->integer.low() == 255, "Numerics should be decoded on load.");
+        std::remove(cache_name.c_str());
+    }
+
+    void test_cache_stale() {
+        // Caches are only used for exactly the
+        // text they were written for.
+        auto source = setup_source();
+        hounddog::assert(cache_write(TokenStream(source), cache_name), "Cache should be written.");
+
+        std::string data(source->view());
+        data[0] = 'y';
+        hounddog::assert(!cache_load(setup_source(data), cache_name), "Cache should not load for changed text.");
+        hounddog::assert(!cache_load(setup_source(data + "\n"), cache_name), "Cache should not load for longer text.");
+
+        // Nor if damaged.
+        {
+            std::fstream file(cache_name, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(4);
+            file.put(TOKEN_CACHE_VERSION + 1);
+        }
+        hounddog::assert(!cache_load(source, cache_name), "Cache should not load from another version.");
+
+        std::remove(cache_name.c_str());
+        hounddog::assert(!cache_load(source, cache_name), "Missing caches should not load.");
+    }
+}
@@ -0,0 +1,48 @@
+#include "tests/hounddog.hpp"
+#include "include/vixen/dfa.hpp"
+
+namespace test_vixen::dfa {
+    using namespace vixen::dfa;
+
+    constexpr Automaton setup_automaton() {
+        Automaton automaton;
+        automaton.distinguish("abcdefghijklmnopqrstuvwxyz");
+        automaton.distinguish_each("=<");
+
+        State name = automaton.state(1);
+        automaton.link(START, "abcdefghijklmnopqrstuvwxyz", name);
+        automaton.link(name, "abcdefghijklmnopqrstuvwxyz", name);
+
+        automaton.add({"<", 2});
+        automaton.add({"<=", 3});
+        automaton.add({"if", 4});
+        return automaton;
+    }
+
+    // Built at compile time.
+    constexpr Automaton automaton = setup_automaton();
+
+    void test_automaton_accept() {
+        std::pair<std::string_view, Accept> cases[] = {
+            {"<", 2},
+            {"<=", 3},
+            {"if", 4},
+            {"i", 1},
+            {"iff", 1},
+            {"name", 1},
+        };
+
+        for (auto const& [spelling, accept] : cases) {
+            State state = automaton.walk(spelling);
+            hounddog::assert(
+                automaton.accept(state) == accept,
+                "'{}' should be accepted with {} not {}.", spelling, accept, automaton.accept(state));
+        }
+    }
+
+    void test_automaton_reject() {
+        hounddog::assert(automaton.walk("=") == DEAD, "'=' should lead nowhere.");
+        hounddog::assert(automaton.walk("<a") == DEAD, "'<a' should lead nowhere.");
+        hounddog::assert(automaton.accept(automaton.walk("")) == DFA_REJECT, "Nothing should not be accepted.");
+    }
+}
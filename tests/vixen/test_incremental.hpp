@@ -0,0 +1,134 @@
+#include <random>
+#include <sstream>
+
+#include "tests/hounddog.hpp"
+#include "include/vixen/incremental.hpp"
+
+namespace test_vixen::incremental {
+    using namespace vixen::incremental;
+
+    std::string setup_text(const IncrementalTree& tree) {
+        std::stringstream buf;
+        buf << tree << "\n" << tree.tree().diagnostics;
+        return buf.str();
+    }
+
+    // Parse `data` from scratch.
+    std::string setup_full(const std::string& data) {
+        auto source = vixen::sources::source_from_string(data);
+        TreeParser parser{Lexer(source)};
+        Tree tree = parse(parser);
+
+        std::stringstream buf;
+        buf << tree << "\n" << tree.diagnostics;
+        return buf.str();
+    }
+
+    void test_edit_reuse() {
+        // Editing one statement reparses only that
+        // statement, and leaves the same tree as
+        // parsing the edited text from scratch.
+        std::string data;
+        for (size_t i = 0; i < 100; i++)
+            data.append("x + y * (z - " + std::to_string(i) + ");\n");
+
+        IncrementalTree tree(vixen::sources::source_from_string(data));
+        hounddog::assert(tree.size() == 100, "Expected 100 statements got {}", tree.size());
+
+        // 'x + y * (z - 50);' becomes 'x + w * (z - 50);'.
+        size_t at = data.find("(z - 50)") - 5;
+        EditStats stats = tree.edit(TextEdit{(vixen::sources::Offset)at, (vixen::sources::Offset)at + 1, "w"});
+        data.replace(at, 1, "w");
+
+        hounddog::assert(stats.reparsed == 1, "Expected 1 statement reparsed got {}", stats.reparsed);
+        hounddog::assert(stats.reused == 99, "Expected 99 statements reused got {}", stats.reused);
+        hounddog::assert(tree.text() == data, "Edited text does not match.");
+
+        std::string expected = setup_full(data);
+        std::string got      = setup_text(tree);
+        hounddog::assert(got == expected, "Expected tree {} got {}", expected, got);
+    }
+
+    void test_edit_random() {
+        // Any series of edits leaves the same tree,
+        // and the same errors, as parsing the
+        // final text from scratch.
+        const std::string pieces[] = {"a", "1", " ", ";", "+", "*", "(", ")", "\n", "bc", "2.5", "if", "\"s\""};
+        std::string data("x + y * (z - 1);\n(1 + 2) // 3 ** a;\nb - c;\n");
+        IncrementalTree tree(vixen::sources::source_from_string(data));
+        std::mt19937 random(7);
+
+        for (size_t i = 0; i < 300; i++) {
+            size_t begin = random() % (data.length() + 1);
+            size_t end   = std::min(data.length(), begin + random() % 4);
+            std::string text = random() % 3 ? pieces[random() % std::size(pieces)] : "";
+
+            tree.edit(TextEdit{(vixen::sources::Offset)begin, (vixen::sources::Offset)end, text});
+            data.replace(begin, end - begin, text);
+
+            std::string expected = setup_full(data);
+            std::string got      = setup_text(tree);
+            if (got != expected) {
+                hounddog::assert(false, "After edit {} of '{}' expected {} got {}", i, data, expected, got);
+                return;
+            }
+        }
+    }
+
+    void test_edit_outside() {
+        // Edits that end past the text, or end
+        // before they begin, are rejected and the
+        // tree is left as it was.
+        std::string data("x + y;\nb - c;\n");
+        IncrementalTree tree(vixen::sources::source_from_string(data));
+        std::string expected = setup_text(tree);
+        vixen::sources::Offset size = data.length();
+
+        for (TextEdit edit : {TextEdit{size, size + 1, "a"}, TextEdit{4, 3, "a"}}) {
+            bool failed = false;
+            try {
+                tree.edit(edit);
+            } catch (const std::out_of_range&) {
+                failed = true;
+            }
+            hounddog::assert(failed, "Edit of [{}, {}) should fail.", edit.begin, edit.end);
+            hounddog::assert(tree.text() == data && setup_text(tree) == expected, "Failed edit should leave the tree as it was.");
+        }
+
+        // An insertion at the very end is within
+        // the text.
+        tree.edit(TextEdit{size, size, "a;\n"});
+        hounddog::assert(tree.text() == data + "a;\n", "Insertion at the end should be applied.");
+    }
+
+    void test_edit_deep() {
+        // Statements kept across an edit are left
+        // as they were, however long their chains,
+        // and their tokens still locate to where
+        // they now lie.
+        const size_t terms = 1 << 20;
+        std::string data("b;\na");
+        for (size_t i = 1; i < terms; i++)
+            data.append(" + a");
+        data.append(";\n");
+
+        IncrementalTree tree(vixen::sources::source_from_string(data));
+        // The outermost '+' of the chain is the
+        // last in the text, its right the last 'a'.
+        TreeNode* chain  = node_program_get(tree.tree().root, 1);
+        Token     before = node_stmt_getright(chain)->token_get();
+
+        EditStats stats = tree.edit(TextEdit{0, 1, "bc"});
+        data.replace(0, 1, "bc");
+
+        hounddog::assert(stats.reparsed == 1 && stats.reused == 1, "Expected 1 statement reparsed and 1 reused got {} and {}", stats.reparsed, stats.reused);
+        hounddog::assert(stats.relexed == 4, "Expected 4 bytes relexed got {}", stats.relexed);
+        hounddog::assert(node_program_get(tree.tree().root, 1) == chain, "Expected the chain to be kept.");
+
+        Token last = node_stmt_getright(chain)->token_get();
+        hounddog::assert(last.symbol == "a" && last.symbol.data() == before.symbol.data() && last.offset == before.offset, "The last 'a' should be left as it was.");
+
+        auto [lineno, column] = last.location(tree.source_ref());
+        hounddog::assert(lineno == 2 && column == data.size() - 3 - 3, "Expected the last 'a' at 2:{} got {}:{}", data.size() - 6, lineno, column);
+    }
+}
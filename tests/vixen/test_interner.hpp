@@ -0,0 +1,64 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tests/hounddog.hpp"
+#include "include/vixen/interner.hpp"
+
+namespace test_vixen::interner {
+    using namespace vixen::interner;
+
+    void test_intern() {
+        Interner interner;
+        std::string symbol("name");
+
+        SymbolId id = interner.intern(symbol);
+        hounddog::assert(id != 0, "Only the empty symbol should have id 0.");
+        hounddog::assert(interner.intern("") == 0, "The empty symbol should have id 0 not {}.", interner.intern(""));
+        hounddog::assert(interner.intern("name") == id, "Equal symbols should share id {}.", id);
+        hounddog::assert(interner.intern("other") != id, "Distinct symbols should not share id {}.", id);
+
+        // Interned text must not depend on the
+        // text it was interned from.
+        symbol[0] = 'g';
+        hounddog::assert(interner.lookup(id) == "name", "Id {} should refer to 'name' not '{}'", id, interner.lookup(id));
+        hounddog::assert(interner.size() == 3, "Expected 3 symbols got {}.", interner.size());
+    }
+
+    void test_intern_large() {
+        // Symbols larger than a block get a block
+        // of their own.
+        Interner interner;
+        std::string large(INTERNER_BLOCK_SIZE * 2, 'x');
+
+        SymbolId small = interner.intern("small");
+        SymbolId id    = interner.intern(large);
+        hounddog::assert(interner.lookup(id) == large, "Large symbol should be interned whole.");
+        hounddog::assert(interner.lookup(small) == "small", "Earlier symbols should not move.");
+    }
+
+    void test_intern_threaded() {
+        // Threads interning the same symbols
+        // must agree on their ids.
+        Interner interner;
+        std::vector<std::vector<SymbolId>> ids(8);
+        std::vector<std::thread> workers;
+
+        for (size_t t = 0; t < ids.size(); t++) {
+            workers.emplace_back([&, t]() {
+                for (int i = 0; i < 2000; i++)
+                    ids[t].push_back(interner.intern("symbol" + std::to_string((i * (t + 1)) % 2000)));
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+
+        hounddog::assert(interner.size() == 2001, "Expected 2001 symbols got {}.", interner.size());
+        for (size_t t = 0; t < ids.size(); t++) {
+            for (int i = 0; i < 2000; i++) {
+                std::string symbol = "symbol" + std::to_string((i * (t + 1)) % 2000);
+                hounddog::assert(interner.lookup(ids[t][i]) == symbol, "Id {} should refer to '{}'", ids[t][i], symbol);
+            }
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#include <string>
+
+#include "tests/hounddog.hpp"
+#include "include/vixen/numerics.hpp"
+
+namespace test_vixen::numerics {
+    using namespace vixen::numerics;
+
+    void test_decode_integer() {
+        std::pair<std::string, uint64_t> cases[] = {
+            {"0", 0},
+            {"175", 175},
+            {"1_000_000", 1000000},
+            {"0b1010_1111", 175},
+            {"0o257", 175},
+            {"0x_af", 175},
+            {"0xAF", 175},
+            {"0d175", 175},
+            {"0x_dead_beef_dead_beef", 0xdeadbeefdeadbeef},
+        };
+
+        for (auto const& [symbol, expected] : cases) {
+            NumericValue value = numeric_decode(symbol);
+            hounddog::assert(value.status == NUMERIC_OK, "'{}' should decode, status {}", symbol, (uint)value.status);
+            hounddog::assert(value.integer.low() == expected, "'{}' should be {} not {}", symbol, expected, value.integer.low());
+        }
+
+        NumericValue negative = numeric_decode("-42");
+        hounddog::assert(negative.negative && negative.as_int64() == -42, "'-42' should be -42 not {}", negative.as_int64());
+
+        hounddog::assert(numeric_decode("1x2").status == NUMERIC_INVALID, "'1x2' should not decode.");
+        hounddog::assert(numeric_decode("0b102").status == NUMERIC_INVALID, "'0b102' should not decode.");
+    }
+
+    void test_decode_wide() {
+        // 256 bit integers decode exactly, wider
+        // ones overflow.
+        std::string max("0x");
+        for (int i = 0; i < 64; i++)
+            max += "f";
+
+        NumericValue value = numeric_decode(max);
+        hounddog::assert(value.status == NUMERIC_OK, "uint256 max should decode, status {}", (uint)value.status);
+        hounddog::assert(value.integer.bits() == 256, "uint256 max should use 256 bits not {}", value.integer.bits());
+        hounddog::assert(value.fits(256, false), "uint256 max should fit in uint256.");
+        hounddog::assert(!value.fits(256, true), "uint256 max should not fit in int256.");
+        hounddog::assert(!value.fits(128, false), "uint256 max should not fit in uint128.");
+
+        // 2 ** 128.
+        value = numeric_decode("340282366920938463463374607431768211456");
+        hounddog::assert(value.integer.bits() == 129, "2 ** 128 should use 129 bits not {}", value.integer.bits());
+        hounddog::assert(!value.fits(128, false) && value.fits(256, true), "2 ** 128 should only fit in 256 bits.");
+
+        value = numeric_decode(max + "0");
+        hounddog::assert(value.status == NUMERIC_OVERFLOW, "Integers wider than 256 bits should overflow.");
+
+        hounddog::assert(numeric_decode("-128").fits(8, true), "-128 should fit in int8.");
+        hounddog::assert(!numeric_decode("128").fits(8, true), "128 should not fit in int8.");
+        hounddog::assert(numeric_decode("255").fits(8, false), "255 should fit in uint8.");
+        hounddog::assert(!numeric_decode("-1").fits(8, false), "-1 should not fit in uint8.");
+    }
+
+    void test_decode_float() {
+        std::pair<std::string, double> cases[] = {
+            {"175.0", 175.0},
+            {".5", 0.5},
+            {"5.", 5.0},
+            {"1_000.25", 1000.25},
+            {"-3.5", -3.5},
+            {"3.141_592_653_589_793_238_462_643_383_279_502_884_197_169_399_375_105_820_974_944", 3.141592653589793},
+        };
+
+        for (auto const& [symbol, expected] : cases) {
+            NumericValue value = numeric_decode(symbol);
+            hounddog::assert(value.kind == NUMERIC_FLT, "'{}' should be a float.", symbol);
+            hounddog::assert(value.status == NUMERIC_OK, "'{}' should decode, status {}", symbol, (uint)value.status);
+            hounddog::assert(value.floating == expected, "'{}' should be {} not {}", symbol, expected, value.floating);
+        }
+    }
+}
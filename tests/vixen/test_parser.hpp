@@ -0,0 +1,579 @@
+#include <sstream>
+
+#include "tests/hounddog.hpp"
+#include "include/vixen/parser.hpp"
+
+namespace test_vixen::parser {
+    using namespace vixen::parser;
+
+    const std::string expressions("x + y * (z - 1); (1 + 2) // 3 ** a;");
+
+    Lexer setup_lexer() {
+        std::string data(expressions);
+        return Lexer(data);
+    }
+
+    std::string setup_tree(const Tree& tree) {
+        std::stringstream buf;
+        buf << tree;
+        return buf.str();
+    }
+
+    void test_parse_dynamic() {
+        // Parsing through the dynamic interface
+        // must build the same tree as parsing
+        // through the tree parser directly.
+        TreeParser tree(setup_lexer());
+        DynamicParser<TreeParser> dynamic{TreeParser(setup_lexer())};
+        Parser& p = dynamic;
+
+        std::string expected = setup_tree(parse(tree));
+        std::string got      = setup_tree(parse(p));
+        hounddog::assert(expected == got, "Expected tree {} got {}", expected, got);
+        hounddog::assert(p.done(), "Dynamic parser should be done with the static one.");
+    }
+
+    // Parse in a helper, so the parser and its
+    // lexer are gone once the tree is returned.
+    Tree setup_returned() {
+        TreeParser tree(setup_lexer());
+        return parse(tree);
+    }
+
+    void test_parse_keeps_source() {
+        // Token symbols are views into the source,
+        // so a tree must keep it alive after the
+        // parser that made it has gone.
+        Tree program = setup_returned();
+        hounddog::assert(program.source != nullptr, "Tree should hold its source.");
+        hounddog::assert(program.source->view() == expressions, "Tree should hold the source it was parsed from.");
+
+        TreeParser tree(setup_lexer());
+        std::string expected = setup_tree(parse(tree));
+        std::string got      = setup_tree(program);
+        hounddog::assert(expected == got, "Expected tree {} got {}", expected, got);
+    }
+
+    void test_parse_node_types() {
+        // Nodes keep their kind as an enum, and
+        // binary nodes are named after their
+        // operation's token type.
+        TreeParser tree(setup_lexer());
+        Tree      program = parse(tree);
+        TreeNode* stmt    = node_program_get(program.root, 0);
+        TreeNode* left    = node_stmt_getleft(stmt);
+
+        hounddog::assert(program.root->node_type() == NodeType::Program, "Root should be a program node.");
+        hounddog::assert(stmt->node_type() == NodeType::Binary, "'x + ...' should be a binary node.");
+        hounddog::assert(stmt->name() == "OperPlus", "'x + ...' should be named OperPlus not {}", stmt->name());
+        hounddog::assert(left->node_type() == NodeType::LiteralName, "'x' should be a name literal.");
+        hounddog::assert(left->name() == "LiteralName", "'x' should be named LiteralName not {}", left->name());
+    }
+
+    size_t count_nodes(const TreeNode* node) {
+        size_t count = 1;
+        for (const TreeNode* stmt : node->body_get())
+            count += count_nodes(stmt);
+        for (NodeSlot slot : {NodeSlot::Value, NodeSlot::Left, NodeSlot::Right}) {
+            if (node->child_get(slot))
+                count += count_nodes(node->child_get(slot));
+        }
+        return count;
+    }
+
+    void test_parse_arena() {
+        // Every node of a tree is made by its
+        // arena, and statements are kept in order
+        // in the program body.
+        TreeParser tree(setup_lexer());
+        Tree program = parse(tree);
+        auto body    = program.root->body_get();
+
+        hounddog::assert(body.size() == 2, "Expected 2 statements got {}", body.size());
+        hounddog::assert(body[0]->name() == "OperPlus", "First statement should be 'x + ...' not {}", body[0]->name());
+        hounddog::assert(body[1]->name() == "OperDivFloor", "Second statement should be '... // ...' not {}", body[1]->name());
+        hounddog::assert(node_program_get(program.root, 2) == nullptr, "Statements past the body should be null.");
+
+        size_t count = count_nodes(program.root);
+        hounddog::assert(count == program.arena.nodes(), "Expected {} nodes made got {}", count, program.arena.nodes());
+        hounddog::assert(program.arena.bytes() >= count * sizeof(TreeNode), "Arena should hold every node.");
+
+        // Moving the tree keeps its nodes where
+        // they are.
+        TreeNode* root  = program.root;
+        Tree      moved = std::move(program);
+        hounddog::assert(moved.root == root && node_program_get(moved.root, 0) == body[0], "Nodes should not move with the tree.");
+
+        // Lists larger than a block are counted
+        // in full.
+        NodeArena arena;
+        std::vector<TreeNode*> list(2 * NODE_ARENA_BLOCK_SIZE / sizeof(TreeNode*), root);
+        arena.make(NodeType::Program);
+        arena.make_list(list);
+        arena.make(NodeType::Program);
+        hounddog::assert(arena.bytes() >= 2 * NODE_ARENA_BLOCK_SIZE + 2 * sizeof(TreeNode), "Expected at least {} bytes got {}", 2 * NODE_ARENA_BLOCK_SIZE + 2 * sizeof(TreeNode), arena.bytes());
+    }
+
+    void test_parse_flat() {
+        // A flattened tree keeps every node, in
+        // pre-order, and prints the same as the
+        // tree it came from.
+        auto stream = std::make_shared<const TokenStream>(vixen::sources::source_from_string(expressions));
+        TreeParser tree(stream);
+        Tree     program = parse(tree);
+        FlatTree flat    = flat_from_tree(program.root, stream);
+
+        std::stringstream buf;
+        buf << flat;
+        std::string expected = setup_tree(program);
+        hounddog::assert(buf.str() == expected, "Expected flat tree {} got {}", expected, buf.str());
+        hounddog::assert(flat.size() == program.arena.nodes(), "Expected {} flat nodes got {}", program.arena.nodes(), flat.size());
+
+        // 'x + y * (z - 1)'
+        NodeIndex stmt = flat.nodes[0].first_child;
+        NodeIndex left = flat.child_get(stmt, NodeSlot::Left);
+        hounddog::assert(stmt == 1 && flat.name(stmt) == "OperPlus", "First statement should be OperPlus at 1.");
+        hounddog::assert(left == 2 && flat.token(left).symbol == "x", "Left of '+' should be 'x' at 2.");
+        hounddog::assert(flat.child_get(left, NodeSlot::Left) == NODE_NONE, "'x' should have no children.");
+        hounddog::assert(flat.token(0).symbol == "", "Program should have no token.");
+    }
+
+    void check_numerics(const Tree& program, const std::string& name) {
+        // 'x = 0x_ff + 1.5 * 7;'
+        TreeNode* sum     = node_stmt_getright(node_program_get(program.root, 0));
+        TreeNode* integer = node_stmt_getleft(sum);
+        TreeNode* product = node_stmt_getright(sum);
+        TreeNode* floated = node_stmt_getleft(product);
+
+        hounddog::assert(node_stmt_getleft(node_program_get(program.root, 0))->numeric() == nullptr, "{}: names should have no value.", name);
+        hounddog::assert(integer->numeric() != nullptr, "{}: '0x_ff' should have a value.", name);
+        hounddog::assert(integer->numeric()->as_int64() == 255, "{}: expected 255 got {}", name, integer->numeric()->as_int64());
+        hounddog::assert(floated->numeric() != nullptr, "{}: '1.5' should have a value.", name);
+        hounddog::assert(floated->numeric()->floating == 1.5, "{}: expected 1.5 got {}", name, floated->numeric()->floating);
+        hounddog::assert(node_stmt_getright(product)->numeric()->as_int64() == 7, "{}: expected 7.", name);
+    }
+
+    void test_parse_numerics() {
+        // Numeric literals carry the values they
+        // were decoded to, whether lexed as the
+        // tree is parsed or read from a stream.
+        std::string data("x = 0x_ff + 1.5 * 7;");
+        TreeParser lexed{Lexer(data)};
+        check_numerics(parse(lexed), "lexer");
+
+        auto stream = std::make_shared<const TokenStream>(vixen::sources::source_from_string(data));
+        TreeParser streamed(stream);
+        check_numerics(parse(streamed), "stream");
+
+        // Flat trees find them by token index.
+        TreeParser again(stream);
+        Tree     program = parse(again);
+        FlatTree flat    = flat_from_tree(program.root, stream);
+        size_t   found   = 0;
+        for (NodeIndex i = 0; i < flat.size(); i++) {
+            if (flat.nodes[i].kind == NodeType::LiteralInt || flat.nodes[i].kind == NodeType::LiteralFlt) {
+                hounddog::assert(flat.numeric(i) != nullptr, "Flat literal '{}' should have a value.", flat.token(i).symbol);
+                found++;
+            }
+        }
+        hounddog::assert(found == 3, "Expected 3 flat numerics got {}", found);
+
+        // Tokens pulled again after a rewind keep
+        // their values.
+        TreeParser rewound{Lexer(data)};
+        ParserMark mark = rewound.mark();
+        parse_stmt(rewound, program.arena);
+        rewound.rewind(mark);
+        rewound.release(mark);
+        rewound.update();
+        rewound.update();
+        hounddog::assert(rewound.numeric() && rewound.numeric()->as_int64() == 255, "Expected 255 after rewinding.");
+        rewound.update();
+        hounddog::assert(rewound.numeric() == nullptr, "'+' should have no value.");
+    }
+
+    void test_parse_flat_deep() {
+        // A long chain of left operands is laid
+        // out and printed without recursing once
+        // per node, and nodes index the stream's
+        // tokens.
+        const size_t terms = 1 << 20;
+        std::string data("a");
+        for (size_t i = 1; i < terms; i++)
+            data.append(" + a");
+        data.append(";");
+
+        auto stream = std::make_shared<const TokenStream>(vixen::sources::source_from_string(data));
+        TreeParser tree(stream);
+        Tree     program = parse(tree);
+        FlatTree flat    = flat_from_tree(program.root, stream);
+
+        hounddog::assert(flat.size() == program.arena.nodes(), "Expected {} flat nodes got {}", program.arena.nodes(), flat.size());
+        hounddog::assert(flat.size() == 2 * terms, "Expected {} flat nodes got {}", 2 * terms, flat.size());
+
+        // The deepest '+' is the first in the
+        // text, its left operand the first 'a'.
+        NodeIndex node = flat.nodes[0].first_child;
+        while (flat.child_get(node, NodeSlot::Left) != NODE_NONE)
+            node = flat.child_get(node, NodeSlot::Left);
+        hounddog::assert(node == terms && flat.nodes[node].token == 0, "First 'a' should be node {} and token 0.", terms);
+        hounddog::assert(stream->offset(flat.nodes[1].token) == data.size() - 4, "Outermost '+' should be the last in the text.");
+
+        std::stringstream buf;
+        buf << flat;
+        hounddog::assert(buf.str() == setup_tree(program), "Flat tree should print as the tree it was laid out from.");
+    }
+
+    void test_parse_print_deep() {
+        // A long chain of left operands prints
+        // without recursing once per node.
+        const size_t terms = 1 << 20;
+        std::string data("a");
+        for (size_t i = 1; i < terms; i++)
+            data.append(" + a");
+        data.append(";");
+
+        auto stream = std::make_shared<const TokenStream>(vixen::sources::source_from_string(data));
+        TreeParser tree(stream);
+        Tree        program = parse(tree);
+        std::string printed = setup_tree(program);
+
+        size_t operators = 0;
+        for (size_t at = printed.find("(+)"); at != std::string::npos; at = printed.find("(+)", at + 1))
+            operators++;
+        hounddog::assert(operators == terms - 1, "Expected {} '+' nodes printed got {}", terms - 1, operators);
+        hounddog::assert(printed.ends_with("]]]"), "Printed tree should close every node.");
+    }
+
+    // Write a tree as nested lists, such as
+    // '(+ a (* b c))'.
+    std::string setup_sexpr(const TreeNode* node) {
+        if (node->node_type() == NodeType::Program) {
+            std::string out;
+            for (const TreeNode* stmt : node->body_get()) {
+                if (!out.empty())
+                    out.append(" ");
+                out.append(setup_sexpr(stmt));
+            }
+            return out;
+        }
+        if (!node_isoperation(node->node_type()))
+            return std::string(node->token_get().symbol);
+
+        std::string out("(");
+        out.append(node->token_get().symbol);
+        for (NodeSlot slot : {NodeSlot::Value, NodeSlot::Left, NodeSlot::Right}) {
+            if (node->child_get(slot)) {
+                out.append(" ");
+                out.append(setup_sexpr(node->child_get(slot)));
+            }
+        }
+        out.append(")");
+        return out;
+    }
+
+    void test_parse_precedence() {
+        // Operators group by precedence, left to
+        // right, except for powers and assignment
+        // which group right to left.
+        std::pair<std::string, std::string> cases[] = {
+            {"a + b * c;", "(+ a (* b c))"},
+            {"a - b - c;", "(- (- a b) c)"},
+            {"a / b // c % d;", "(% (// (/ a b) c) d)"},
+            {"a ** b ** c;", "(** a (** b c))"},
+            {"a * b ** c;", "(* a (** b c))"},
+            {"(a + b) * c;", "(* (+ a b) c)"},
+            {"-a * b;", "(* (- a) b)"},
+            {"-a ** b;", "(- (** a b))"},
+            {"!a && b || c;", "(|| (&& (! a) b) c)"},
+            {"a == b + c;", "(== a (+ b c))"},
+            {"a < b == c >= d;", "(== (< a b) (>= c d))"},
+            {"a | b ^ c & d;", "(| a (^ b (& c d)))"},
+            {"a = b = c + d;", "(= a (= b (+ c d)))"},
+            {"a += b * c;", "(+= a (* b c))"},
+        };
+
+        for (auto [text, expected] : cases) {
+            TreeParser tree{Lexer(text)};
+            Tree program = parse(tree);
+
+            std::string got = setup_sexpr(program.root);
+            hounddog::assert(got == expected, "Expected '{}' to parse as {} got {}", text, expected, got);
+        }
+    }
+
+    void test_parser_lookahead() {
+        // Tokens past the current one are visible
+        // in order, and stay put as the parser
+        // moves on to them.
+        std::string data("a + b * c - d;");
+        TreeParser tree{Lexer(data)};
+        std::string_view expected[] = {"a", "+", "b", "*", "c", "-", "d", ";"};
+
+        for (size_t at = 0; at < std::size(expected); at++) {
+            for (size_t count = 0; count <= PARSER_LOOKAHEAD && at + count < std::size(expected); count++) {
+                SymbolView got = tree.peek(count).symbol;
+                hounddog::assert(got == expected[at + count], "Expected '{}' {} past {} got '{}'", expected[at + count], count, at, got);
+            }
+            if (at)
+                hounddog::assert(tree.previous().symbol == expected[at - 1], "Expected previous '{}' got '{}'", expected[at - 1], tree.previous().symbol);
+            tree.update();
+        }
+
+        // The end of input is seen from then on.
+        hounddog::assert(tree.done(), "Parser should be done after ';'.");
+        for (size_t count = 0; count <= PARSER_LOOKAHEAD; count++)
+            hounddog::assert(tokens_isend(tree.peek(count).type), "Expected the end of input {} past the end.", count);
+
+        // Nothing past the lookahead is seen.
+        bool failed = false;
+        try {
+            tree.peek(PARSER_LOOKAHEAD + 1);
+        } catch (const std::out_of_range&) {
+            failed = true;
+        }
+        hounddog::assert(failed, "Peeking past the lookahead should fail.");
+    }
+
+    void test_parser_isdeclaration() {
+        // Declarations are told apart from
+        // expressions before either is parsed.
+        std::pair<std::string, bool> cases[] = {
+            {"x: int;", true},
+            {"x, y: int;", true},
+            {"x, y;", false},
+            {"x + y;", false},
+            {"1: int;", false},
+        };
+
+        for (auto [text, expected] : cases) {
+            TreeParser tree{Lexer(text)};
+            bool got = parse_isdeclaration(tree);
+            hounddog::assert(got == expected, "Expected '{}' declaration to be {}", text, expected);
+            hounddog::assert(tree.current().symbol == text.substr(0, tree.current().symbol.length()), "Looking ahead should not move the parser.");
+        }
+
+        // Names past the lookahead are not looked
+        // for, a deeper parser finds them.
+        std::string text("x, y, z: int;");
+        TreeParser shallow{Lexer(text)};
+        hounddog::assert(!parse_isdeclaration(shallow), "'{}' should not fit in a lookahead of {}", text, shallow.lookahead());
+        BasicTreeParser<8> deep{Lexer(text)};
+        hounddog::assert(parse_isdeclaration(deep), "'{}' should fit in a lookahead of {}", text, deep.lookahead());
+    }
+
+    template <TokenRewinding P>
+    void check_rewind(P& tree, const std::string& name) {
+        // Parse a statement, rewind and parse it
+        // again; both parses must agree, and so
+        // must the tokens after them.
+        ParserMark mark = tree.mark();
+        NodeArena  arena;
+        std::stringstream first, second;
+
+        first << *parse_stmt(tree, arena);
+        Token after = tree.current();
+        tree.rewind(mark);
+        hounddog::assert(tree.previous().symbol == "", "{}: rewinding to the start should leave no previous token.", name);
+        second << *parse_stmt(tree, arena);
+        hounddog::assert(first.str() == second.str(), "{}: expected {} after rewinding got {}", name, first.str(), second.str());
+        hounddog::assert(tree.current().offset == after.offset, "{}: expected to stop at {} got {}", name, after.offset, tree.current().offset);
+
+        // Rewind across whole batches of tokens,
+        // and to the end of input.
+        while (!tree.done())
+            tree.update();
+        ParserMark end = tree.mark();
+        tree.rewind(mark);
+        hounddog::assert(tree.current().symbol == "x", "{}: expected 'x' after rewinding got '{}'", name, tree.current().symbol);
+        for (size_t i = 0; i < 2 * TOKEN_BATCH_SIZE; i++)
+            tree.update();
+        ParserMark middle = tree.mark();
+        Token expected = tree.current();
+
+        tree.rewind(end);
+        hounddog::assert(tree.done(), "{}: expected the end of input after rewinding to it.", name);
+        tree.rewind(middle);
+        hounddog::assert(tree.current().offset == expected.offset, "{}: expected offset {} got {}", name, expected.offset, tree.current().offset);
+        hounddog::assert(tree.previous().offset < expected.offset, "{}: previous token should come before the current one.", name);
+
+        tree.release(middle);
+        tree.release(end);
+        tree.release(mark);
+    }
+
+    void test_parser_rewind() {
+        std::string data;
+        for (size_t i = 0; i < TOKEN_BATCH_SIZE; i++)
+            data.append("x + y * (z - 1);\n");
+
+        TreeParser lexed{Lexer(data)};
+        check_rewind(lexed, "lexer");
+
+        auto stream = std::make_shared<const TokenStream>(vixen::sources::source_from_string(data));
+        TreeParser streamed(stream);
+        check_rewind(streamed, "stream");
+    }
+
+    void test_parser_rewind_boundary() {
+        // A mark taken just after a batch of
+        // tokens has been lexed, with no other
+        // mark held, rewinds to the marked token
+        // and the one before it.
+        std::string data;
+        for (size_t i = 0; i < 4 * TOKEN_BATCH_SIZE; i++)
+            data.append("a").append(std::to_string(i)).append(" ");
+
+        for (size_t at = TOKEN_BATCH_SIZE - 4; at < TOKEN_BATCH_SIZE + PARSER_LOOKAHEAD + 4; at++) {
+            TreeParser tree{Lexer(data)};
+            for (size_t i = 0; i < at; i++)
+                tree.update();
+
+            ParserMark mark     = tree.mark();
+            Token      current  = tree.current();
+            Token      previous = tree.previous();
+            for (size_t i = 0; i < 10; i++)
+                tree.update();
+
+            tree.rewind(mark);
+            hounddog::assert(tree.current().offset == current.offset, "Marked at {}: expected '{}' got '{}'", at, current.symbol, tree.current().symbol);
+            hounddog::assert(tree.previous().offset == previous.offset, "Marked at {}: expected '{}' before got '{}'", at, previous.symbol, tree.previous().symbol);
+            tree.release(mark);
+        }
+    }
+
+    void test_parser_rewind_released() {
+        // Tokens are let go once no mark holds
+        // them, so rewinding to a released mark
+        // fails rather than landing elsewhere.
+        std::string data;
+        for (size_t i = 0; i < 4 * TOKEN_BATCH_SIZE; i++)
+            data.append("a").append(std::to_string(i)).append(" ");
+
+        TreeParser tree{Lexer(data)};
+        ParserMark mark = tree.mark();
+        tree.release(mark);
+        for (size_t i = 0; i < 2 * TOKEN_BATCH_SIZE; i++)
+            tree.update();
+
+        bool failed = false;
+        try {
+            tree.rewind(mark);
+        } catch (const std::out_of_range&) {
+            failed = true;
+        }
+        hounddog::assert(failed, "Rewinding to a released mark should fail.");
+    }
+
+    void test_parser_memoized() {
+        // A rule already parsed at a position is
+        // not parsed there again, and the parser
+        // is left where the rule left it.
+        std::string data(expressions);
+        TreeParser tree{Lexer(data)};
+        NodeArena  arena;
+        ParseMemo  memo;
+        size_t     calls = 0;
+
+        auto rule = [&](TreeParser& parser, NodeArena& arena) {
+            calls++;
+            return parse_stmt(parser, arena);
+        };
+
+        ParserMark start = tree.mark();
+        TreeNode*  first = parse_memoized(tree, arena, memo, 1, rule);
+        Token      after = tree.current();
+
+        tree.rewind(start);
+        TreeNode* second = parse_memoized(tree, arena, memo, 1, rule);
+        hounddog::assert(calls == 1, "Expected the rule to be parsed once got {}", calls);
+        hounddog::assert(first == second, "Expected the same node to be reused.");
+        hounddog::assert(tree.current().offset == after.offset, "Expected to stop at {} got {}", after.offset, tree.current().offset);
+
+        tree.rewind(start);
+        parse_memoized(tree, arena, memo, 2, rule);
+        hounddog::assert(calls == 2 && memo.size() == 2, "Other rules should not share results.");
+
+        // Rules differing only above their low
+        // 16 bits are still told apart.
+        tree.rewind(start);
+        parse_memoized(tree, arena, memo, 2 + (1 << 16), rule);
+        hounddog::assert(calls == 3 && memo.size() == 3, "Rule {} should not share results with rule 2.", 2 + (1 << 16));
+        tree.release(start);
+    }
+
+    void test_parse_recovery() {
+        // Every error is reported in one pass,
+        // each statement in error is stood in for
+        // by an error node, and parsing resumes
+        // at the next statement.
+        std::string data("x + ); 1 2 3; (a + b; y * 2; if z; w; ((((;");
+        TreeParser tree{Lexer(data)};
+        Tree program = parse(tree);
+
+        std::pair<size_t, std::string> expected[] = {
+            {4,  "Unexpected token ')'."},
+            {9,  "Expected PuncTerminator got '2'."},
+            {20, "Expected PuncRParen got ';'."},
+            {29, "Unexpected token 'if'."},
+            {42, "Unexpected token ';'."},
+        };
+        hounddog::assert(program.diagnostics.size() == std::size(expected), "Expected {} errors got {}", std::size(expected), program.diagnostics.size());
+        for (size_t i = 0; i < std::size(expected); i++) {
+            const auto& diagnostic = program.diagnostics[i];
+            hounddog::assert(diagnostic.token.offset == expected[i].first, "Expected error {} at {} got {}", i, expected[i].first, diagnostic.token.offset);
+            hounddog::assert(diagnostic.message == expected[i].second, "Expected error '{}' got '{}'", expected[i].second, diagnostic.message);
+        }
+
+        std::stringstream buf;
+        buf << program.diagnostics[0];
+        hounddog::assert(buf.str() == "1:5: error: Unexpected token ')'.", "Unexpected diagnostic format {}", buf.str());
+
+        auto body = program.root->body_get();
+        std::string names[] = {"OperPlus", "LiteralInt", "Error", "OperStar", "Error", "LiteralName", "Error"};
+        hounddog::assert(body.size() == std::size(names), "Expected {} statements got {}", std::size(names), body.size());
+        for (size_t i = 0; i < std::min(body.size(), std::size(names)); i++)
+            hounddog::assert(body[i]->name() == names[i], "Expected statement {} to be {} got {}", i, names[i], body[i]->name());
+        hounddog::assert(node_stmt_getright(body[0])->node_type() == NodeType::Error, "')' should be stood in for by an error node.");
+    }
+
+    void test_parse_empty_statement() {
+        // A lone ';' is an empty statement, and one
+        // within an expression ends it early; it is
+        // never an operand.
+        std::string data("; + 1; x * ;; y;");
+        TreeParser tree{Lexer(data)};
+        Tree program = parse(tree);
+
+        hounddog::assert(program.diagnostics.size() == 1, "Expected 1 error got {}", program.diagnostics.size());
+        hounddog::assert(program.diagnostics[0].token.offset == 11, "Expected error at 11 got {}", program.diagnostics[0].token.offset);
+
+        auto body = program.root->body_get();
+        NodeType types[] = {NodeType::Terminator, NodeType::Unary, NodeType::Binary, NodeType::Terminator, NodeType::LiteralName};
+        hounddog::assert(body.size() == std::size(types), "Expected {} statements got {}", std::size(types), body.size());
+        for (size_t i = 0; i < std::min(body.size(), std::size(types)); i++)
+            hounddog::assert(body[i]->node_type() == types[i], "Unexpected node type for statement {}: {}", i, body[i]->name());
+        hounddog::assert(node_stmt_getright(body[2])->node_type() == NodeType::Error, "';' should be stood in for by an error node.");
+    }
+
+    void test_parse_recovery_end() {
+        // Input that ends part way through a
+        // statement is reported once, and valid
+        // input reports nothing.
+        std::string data("a + b;\nc * (d;\ne +");
+        TreeParser tree{Lexer(data)};
+        Tree program = parse(tree);
+
+        hounddog::assert(program.diagnostics.size() == 2, "Expected 2 errors got {}", program.diagnostics.size());
+        hounddog::assert(program.diagnostics[1].message == "Unexpected end of input.", "Unexpected error '{}'", program.diagnostics[1].message);
+
+        // Columns are written from 1 on every
+        // line.
+        std::stringstream buf;
+        buf << program.diagnostics[0];
+        hounddog::assert(buf.str() == "2:7: error: Expected PuncRParen got ';'.", "Unexpected diagnostic format {}", buf.str());
+
+        TreeParser valid(setup_lexer());
+        hounddog::assert(parse(valid).diagnostics.empty(), "Valid input should report no errors.");
+    }
+}
@@ -0,0 +1,88 @@
+#include <string>
+#include <vector>
+
+#include "tests/hounddog.hpp"
+#include "include/vixen/simd.hpp"
+#include "include/vixen/symbols.hpp"
+
+namespace test_vixen::simd {
+    using namespace vixen::simd;
+
+    // Inputs mixing long runs of whitespace and
+    // newlines with stops at every offset of a
+    // 32 byte stride.
+    std::vector<std::string> setup_spaces() {
+        std::vector<std::string> inputs;
+        std::string pattern(" \t\n\r\v\f  \n");
+
+        for (size_t length = 0; length < 80; length++) {
+            std::string input;
+            for (size_t i = 0; i < length; i++)
+                input += pattern[(i * 7 + length) % pattern.length()];
+            inputs.push_back(input);
+            inputs.push_back(input + "x   \n");
+        }
+        return inputs;
+    }
+
+    void assert_span_equal(const SkipSpan& expected, const SkipSpan& got, const std::string& name) {
+        hounddog::assert(expected.stop == got.stop, "{} stopped at the wrong byte.", name);
+        hounddog::assert(expected.newlines == got.newlines, "{} counted {} newlines not {}.", name, got.newlines, expected.newlines);
+        hounddog::assert(expected.last_newline == got.last_newline, "{} found the wrong last newline.", name);
+    }
+
+    void test_byte_isspace() {
+        for (int i = 0; i < 256; i++) {
+            hounddog::assert(
+                byte_isspace((char)i) == vixen::symbols::char_isnoparse((char)i),
+                "Byte {} whitespace class must match 'char_isnoparse'.", i);
+        }
+    }
+
+    void test_skip_space() {
+        for (auto const& input : setup_spaces()) {
+            const char* begin = input.data();
+            const char* end   = begin + input.length();
+            SkipSpan expected = skip_space_scalar(begin, end);
+
+            assert_span_equal(expected, skip_space(begin, end), "skip_space");
+            #if defined(__x86_64__)
+            assert_span_equal(expected, skip_space_sse2(begin, end), "skip_space_sse2");
+            if (__builtin_cpu_supports("avx2"))
+                assert_span_equal(expected, skip_space_avx2(begin, end), "skip_space_avx2");
+            #endif
+        }
+    }
+
+    void test_skip_line() {
+        std::string input("# a comment\nx");
+        const char* begin = input.data();
+        const char* end   = begin + input.length();
+
+        hounddog::assert(*skip_line(begin, end) == '\n', "Line should stop at its newline.");
+        hounddog::assert(skip_line(begin + 12, end) == end, "Last line should stop at the end of input.");
+    }
+
+    void test_index_newlines() {
+        for (auto const& input : setup_spaces()) {
+            const char* begin = input.data();
+            const char* end   = begin + input.length();
+            std::vector<uint32_t> expected;
+            std::vector<uint32_t> got;
+
+            index_newlines_scalar(begin, end, 7, expected);
+            index_newlines(begin, end, 7, got);
+            hounddog::assert(expected == got, "index_newlines found the wrong newlines.");
+            #if defined(__x86_64__)
+            got.clear();
+            index_newlines_sse2(begin, end, 7, got);
+            hounddog::assert(expected == got, "index_newlines_sse2 found the wrong newlines.");
+            if (__builtin_cpu_supports("avx2")) {
+                got.clear();
+                index_newlines_avx2(begin, end, 7, got);
+                hounddog::assert(expected == got, "index_newlines_avx2 found the wrong newlines.");
+            }
+            #endif
+        }
+    }
+}
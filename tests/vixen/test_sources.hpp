@@ -0,0 +1,195 @@
+#include <fstream>
+#include <sstream>
+
+#include "tests/hounddog.hpp"
+#include "include/vixen/sources.hpp"
+#include "include/vixen/tokens.hpp"
+
+namespace test_vixen::sources {
+    using namespace vixen::sources;
+
+    const std::string file_name("examples/test_symbols.vxn");
+
+    std::string setup_contents() {
+        std::ifstream file(file_name);
+        std::stringstream buf;
+        buf << file.rdbuf();
+        return buf.str();
+    }
+
+    void test_source_open() {
+        SourceRef source = source_open(file_name);
+        hounddog::assert(source != nullptr, "Could not open test file '{}'", file_name);
+        hounddog::assert(source->name == file_name, "Source should be named '{}' not '{}'", file_name, source->name);
+        hounddog::assert(source->view() == setup_contents(), "Mapped source must match the file contents.");
+    }
+
+    void test_source_open_missing() {
+        hounddog::assert(source_open("examples/does_not_exist.vxn") == nullptr, "Opening a missing file should fail.");
+        hounddog::assert_error(
+            []() { vixen::tokens::Lexer lexer(source_open("examples/does_not_exist.vxn")); },
+            "Lexing a missing file should fail.");
+    }
+
+    void test_source_from_fd() {
+        // Pipes cannot be mapped and must be read
+        // through instead.
+        int fds[2];
+        hounddog::assert(pipe(fds) == 0, "Could not open a pipe.");
+
+        std::string data("x: int = 1;\n");
+        hounddog::assert(write(fds[1], data.data(), data.length()) == (ssize_t)data.length(), "Could not write to pipe.");
+        close(fds[1]);
+
+        SourceRef source = source_from_fd(fds[0], "<pipe>");
+        close(fds[0]);
+        hounddog::assert(source != nullptr, "Reading from a pipe should not fail.");
+        hounddog::assert(source->view() == data, "Source read from pipe must match what was written.");
+    }
+
+    // Write `data` to a new temporary file,
+    // returning its name.
+    std::string setup_file(const std::string& data) {
+        char name[] = "/tmp/vixen_test_sourceXXXXXX";
+        int fd = mkstemp(name);
+        hounddog::assert(fd >= 0, "Could not create a temporary file.");
+        hounddog::assert(write(fd, data.data(), data.length()) == (ssize_t)data.length(), "Could not write temporary file.");
+        close(fd);
+        return name;
+    }
+
+    // Read end of a pipe `data` has been written
+    // to.
+    int setup_pipe(const std::string& data) {
+        int fds[2];
+        hounddog::assert(pipe(fds) == 0, "Could not open a pipe.");
+        hounddog::assert(write(fds[1], data.data(), data.length()) == (ssize_t)data.length(), "Could not write to pipe.");
+        close(fds[1]);
+        return fds[0];
+    }
+
+    void test_source_newline() {
+        // Text without a final newline is given
+        // one however it is read, so it lexes and
+        // locates the same along every path. Mapped
+        // files are tried both ending within a page
+        // and filling their last page.
+        std::string short_data("x: int = 1;\ny");
+        std::string paged_data(getpagesize() - 1, ' ');
+        paged_data.append("y");
+
+        for (const std::string& data : {short_data, paged_data}) {
+            std::string expected = data + "\n";
+            std::string name     = setup_file(data);
+            std::istringstream stream(data);
+            int fd = setup_pipe(data);
+
+            SourceRef sources[] = {
+                source_open(name),
+                source_from_fd(fd),
+                source_from_stream(stream),
+            };
+            close(fd);
+            unlink(name.c_str());
+
+            for (const SourceRef& source : sources) {
+                hounddog::assert(source != nullptr, "Source should have been read.");
+                hounddog::assert(source->view() == expected, "Source should end with a newline.");
+            }
+        }
+
+        // And the same tokens are lexed, read in
+        // whole or a chunk at a time.
+        vixen::tokens::Lexer expected(source_from_string(short_data + "\n"));
+        int fd = setup_pipe(short_data);
+        vixen::tokens::Lexer whole(source_from_fd(fd));
+        close(fd);
+        fd = setup_pipe(short_data);
+        vixen::tokens::StreamLexer chunked(fd, "<pipe>", 3);
+
+        while (!expected.end()) {
+            auto ex = expected.next();
+            auto pr = whole.next();
+            auto ch = chunked.next();
+            hounddog::assert(
+                ex.symbol == pr.symbol && ex.type == pr.type && ex.lineno() == pr.lineno() && ex.column() == pr.column(),
+                "Expected '{}' @({}, {}) got '{}' @({}, {})", ex.symbol, ex.lineno(), ex.column(), pr.symbol, pr.lineno(), pr.column());
+            hounddog::assert(
+                ex.symbol == ch.symbol && ex.type == ch.type && ex.lineno() == ch.lineno() && ex.column() == ch.column(),
+                "Expected '{}' @({}, {}) got '{}' @({}, {}) in chunks", ex.symbol, ex.lineno(), ex.column(), ch.symbol, ch.lineno(), ch.column());
+        }
+        hounddog::assert(whole.end() && chunked.end(), "Every lexer should be exhausted together.");
+        close(fd);
+    }
+
+    void test_lexer_mapped() {
+        // Lexing in place must produce the same
+        // tokens as lexing from a stream.
+        SourceRef source = source_open(file_name);
+        hounddog::assert(source != nullptr, "Could not open test file '{}'", file_name);
+
+        std::ifstream file(file_name);
+        vixen::tokens::Lexer streamed(file, file_name);
+        vixen::tokens::Lexer mapped(source);
+
+        while (!streamed.end()) {
+            auto expected = streamed.next();
+            auto got      = mapped.next();
+            hounddog::assert(
+                expected.symbol == got.symbol && expected.lineno() == got.lineno() && expected.column() == got.column(),
+                "Expected '{}' got '{}'", expected.symbol, got.symbol);
+        }
+        hounddog::assert(mapped.end(), "Mapped lexer should be exhausted with the streamed one.");
+    }
+
+    void test_line_index() {
+        std::string data("ab\n\ncd\ne");
+        LineIndex index;
+        index.append(data.data(), data.data() + data.length());
+
+        std::pair<Offset, Location> cases[] = {
+            {0, {1, 0}},
+            {2, {1, 2}},
+            {3, {2, 1}},
+            {4, {3, 1}},
+            {6, {3, 3}},
+            {7, {4, 1}},
+        };
+        for (auto const& [offset, expected] : cases) {
+            Location got = index.locate(offset);
+            hounddog::assert(
+                got == expected,
+                "Offset {} should be at ({}, {}) not ({}, {}).",
+                offset, expected.first, expected.second, got.first, got.second);
+        }
+
+        // Dropped newlines are still counted for
+        // the offsets after them.
+        index.drop(4);
+        for (auto const& [offset, expected] : cases) {
+            if (offset < 4)
+                continue;
+            Location got = index.locate(offset);
+            hounddog::assert(
+                got == expected,
+                "Offset {} should be at ({}, {}) not ({}, {}) once dropped before.",
+                offset, expected.first, expected.second, got.first, got.second);
+        }
+    }
+
+    void test_source_registry() {
+        SourceRef source = source_from_string("x;\n", "<registry>");
+        FileId    id     = source_register(source);
+
+        hounddog::assert(id != 0, "Source should have been given an id.");
+        hounddog::assert(source_register(source) == id, "Source should keep its id.");
+        hounddog::assert(source_lookup(id) == source, "Id {} should refer back to its source.", id);
+
+        // Ids are recycled once their source is
+        // released.
+        source.reset();
+        hounddog::assert(source_lookup(id) == nullptr, "Released source should not be found.");
+        SourceRef other = source_from_string("y;\n");
+        hounddog::assert(source_register(other) == id, "Id {} should have been recycled.", id);
+    }
+}
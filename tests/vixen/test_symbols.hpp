@@ -1,5 +1,8 @@
 #include <sstream>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include "tests/hounddog.hpp"
 #include "include/vixen/symbols.hpp"
 
@@ -21,6 +24,24 @@ namespace test_vixen::symbols {
         hounddog::assert(char_in_string('c', "charlie"), "'c' is present but not found in 'charlie'.");
     }
 
+    void test_char_class_table() {
+        // Every byte must be classified exactly as
+        // a search through the class literals
+        // would have.
+        for (int i = 0; i < 256; i++) {
+            const char ch = (char)i;
+            hounddog::assert(
+                char_isdigitchar(ch) == char_in_string(ch, "1234567890"),
+                "Byte {} misclassified as digit char.", i);
+            hounddog::assert(
+                char_isnoparse(ch) == char_in_string(ch, " \t\n\r\v\f"),
+                "Byte {} misclassified as whitespace.", i);
+            hounddog::assert(
+                char_isstrchar(ch) == char_in_string(ch, "'`\""),
+                "Byte {} misclassified as string char.", i);
+        }
+    }
+
     void test_char_iscomment() {
         hounddog::assert(!char_iscomment('@'), "'@' should not be valid comment character.");
         hounddog::assert(char_iscomment('#'), "'#' should be valid comment character.");
@@ -166,6 +187,12 @@ namespace test_vixen::symbols {
 
         for (auto const& symbol : valid_stringsyms)
             hounddog::assert(symbol_isstrsym(symbol), "'{}' should be a valid string symbol.", symbol);
+
+        std::string invalid_stringsyms[] = {
+            "", "''", "'\"'", "''''", "'`'", "a", "aaa"};
+
+        for (auto const& symbol : invalid_stringsyms)
+            hounddog::assert(!symbol_isstrsym(symbol), "'{}' should not be a valid string symbol.", symbol);
     }
 
     void test_symbol_istermed() {
@@ -186,6 +213,65 @@ namespace test_vixen::symbols {
         hounddog::assert(symbol_next_isvalidnum("12_", '7'), "'12_' and '7' should compose a valid numerical symbol.");
     }
 
+    void test_numeric_scan() {
+        std::pair<std::string, NumericKind> kinds[] = {
+            {"0b1011", NUMERIC_BIN},
+            {"3.14", NUMERIC_FLT},
+            {".4", NUMERIC_FLT},
+            {"0x5f", NUMERIC_HEX},
+            {"0o77", NUMERIC_OCT},
+            {"100_000", NUMERIC_INT},
+        };
+
+        for (auto const& [symbol, kind] : kinds) {
+            NumericScan scan(symbol);
+            hounddog::assert(scan.isnumeric(), "'{}' should be a valid numerical symbol.", symbol);
+            hounddog::assert(scan.kind() == kind, "'{}' should be of kind {} not {}.", symbol, (int)kind, (int)scan.kind());
+        }
+
+        hounddog::assert(!NumericScan("1.2.3").isnumeric(), "'1.2.3' has too many floating points.");
+        hounddog::assert(!NumericScan("0x1.5").isnumeric(), "'0x1.5' mixes base notation and floating point.");
+        hounddog::assert(!NumericScan("0b1f").isnumeric(), "'0b1f' should not allow alpha characters.");
+    }
+
+    void test_parser_numeric_long() {
+        // Numerics of any length are lexed as one
+        // symbol.
+        std::string numeric("1");
+        for (int i = 0; i < 4096; i++)
+            numeric += "_000";
+
+        std::string data(numeric + ".5;\n");
+        RawParser p(data);
+        auto const [lineno, column, symbol] = p.next();
+        hounddog::assert(symbol == numeric + ".5", "Long numeric should be parsed whole, got {} chars.", symbol.length());
+    }
+
+    void test_parser_string_long() {
+        // String bodies of any length are parsed
+        // as one symbol, without allocating, and
+        // lines within them are still counted.
+        std::string body;
+        for (int i = 0; i < 4096; i++)
+            body += "text with an \\\" escaped quote\n";
+
+        std::string data("x = \"" + body + "\";\n");
+        RawParser p(data);
+        p.next_view();
+        p.next_view();
+        p.next_view();
+
+        size_t before = hounddog::allocations();
+        auto const [lineno, column, symbol] = p.next_view();
+        auto const [close_lineno, close_column, close] = p.next_view();
+        size_t made = hounddog::allocations() - before;
+
+        hounddog::assert(made == 0, "Parsing a string should not allocate, made {} allocations", made);
+        hounddog::assert(symbol == body, "String body should be parsed whole, got {} chars.", symbol.length());
+        hounddog::assert(close == "\"", "String should be closed by '\"' not '{}'", close);
+        hounddog::assert(close_lineno == 4097, "String should close on line 4097 not {}", close_lineno);
+    }
+
     void test_parser_no_error() {
         hounddog::assert_noerr(
             [](){setup_parser();},
@@ -236,6 +322,23 @@ namespace test_vixen::symbols {
         hounddog::assert(p.lookahead(2) == "sx", "Next 2 characters should be 'sx' got '{}'.", p.lookahead(2));
     }
 
+    void test_parser_skip_indented() {
+        // Long runs of indentation and comment
+        // lines are skipped in bulk; line and
+        // column must come out the same as if
+        // walked one char at a time.
+        std::string data;
+        for (int i = 0; i < 40; i++)
+            data += "\n        \t# an indented comment line\n\n";
+        data += "    x;\n";
+
+        RawParser p(data);
+        auto const [lineno, column, symbol] = p.next();
+        hounddog::assert(symbol == "x", "Symbol should be 'x' got '{}'.", symbol);
+        hounddog::assert(lineno == 121, "Lineno position should be at lineno 121 not {}.", lineno);
+        hounddog::assert(column == 5, "Column position should be at column 5 not {}.", column);
+    }
+
     void test_parser_parse_expected() {
         RawParser p = setup_parser();
         TRIPLET(Symbol) symbols_expected[] = {
@@ -290,4 +393,98 @@ namespace test_vixen::symbols {
                 prcolumn);
         }
     }
+
+    void test_stream_parser_expected() {
+        const std::string file_name("examples/test_symbols.vxn");
+
+        // Chunk sizes small enough that every kind
+        // of symbol, including the triple quoted
+        // string, is split across chunks.
+        for (size_t chunk : {1, 3, 16, 4096}) {
+            RawParser expected = setup_parser();
+            int fd = open(file_name.c_str(), O_RDONLY);
+            hounddog::assert(fd >= 0, "Could not open test file '{}'", file_name);
+
+            StreamParser p(fd, file_name, chunk);
+            while (!expected.end()) {
+                auto const [exlineno, excolumn, exsymbol] = expected.next();
+                auto const [prlineno, prcolumn, prsymbol] = p.next();
+                hounddog::assert(
+                    exlineno == prlineno && excolumn == prcolumn && exsymbol == prsymbol,
+                    "Chunk size {}; expected '{}' @({}, {}). Got '{}' @({}, {})",
+                    chunk, exsymbol, exlineno, excolumn, prsymbol, prlineno, prcolumn);
+            }
+            hounddog::assert(p.end(), "Stream parser should be exhausted with the raw parser.");
+            close(fd);
+        }
+    }
+
+    void test_stream_parser_bounded() {
+        // Input many times larger than the chunk
+        // size must be parsed within a window, and
+        // an index of its lines, a small multiple
+        // of the chunk size.
+        char file_name[] = "/tmp/vixen_test_streamXXXXXX";
+        int fd = mkstemp(file_name);
+        hounddog::assert(fd >= 0, "Could not create a temporary file.");
+
+        std::string line("x + (y * z) ** 3; # comment\ns: str = '''a\nb''';\n");
+        for (int i = 0; i < 4096; i++)
+            hounddog::assert(write(fd, line.data(), line.length()) == (ssize_t)line.length(), "Could not write temporary file.");
+        lseek(fd, 0, SEEK_SET);
+
+        StreamParser p(fd, file_name, 256);
+        uint symbols = 0;
+        while (!p.end()) {
+            p.next();
+            symbols++;
+        }
+        close(fd);
+        unlink(file_name);
+
+        // Eighteen symbols a line pair, and EOF.
+        hounddog::assert(symbols == 4096 * 18 + 1, "Should have parsed {} symbols not {}.", 4096 * 18 + 1, symbols);
+        hounddog::assert(p.resident() <= 1024, "Window and line index should stay bounded, grew to {} bytes.", p.resident());
+    }
+
+    void test_stream_parser_empty() {
+        // A parser made without a descriptor has
+        // a stream of its own, read as empty.
+        StreamParser p;
+        hounddog::assert(p.end(), "Parser over no input should be at its end.");
+
+        auto const [lineno, column, symbol] = p.next();
+        hounddog::assert(p.symbol_isend(symbol), "Expected the end of input got '{}'", symbol);
+        hounddog::assert(p.end(), "Parser should stay at its end.");
+        hounddog::assert(p.error() == 0, "Parser over no input should not fail, got errno {}", p.error());
+    }
+
+    void test_stream_parser_read_error() {
+        // Reading a directory fails, which ends
+        // the parser but is kept apart from the
+        // end of the text.
+        const std::string dir_name("examples");
+        int fd = open(dir_name.c_str(), O_RDONLY);
+        hounddog::assert(fd >= 0, "Could not open test directory '{}'", dir_name);
+
+        StreamParser p(fd, dir_name);
+        close(fd);
+        hounddog::assert(p.end(), "Parser should end once a read fails.");
+        hounddog::assert(p.error() == EISDIR, "Expected errno {} got {}", EISDIR, p.error());
+    }
+
+    void test_dynamic_parser_expected() {
+        // Parsing through the dynamic interface
+        // must not change what is parsed.
+        RawParser expected = setup_parser();
+        DynamicSymbolParser<RawParser> dynamic(setup_parser());
+        SymbolParser<TRIPLET(Symbol)>& p = dynamic;
+
+        while (!expected.end()) {
+            auto const ex = expected.next();
+            auto const pr = p.next();
+            hounddog::assert(ex == pr, "Expected '{}' got '{}'", std::get<2>(ex), std::get<2>(pr));
+        }
+        hounddog::assert(p.end(), "Dynamic parser should be exhausted with the static one.");
+    }
 }
@@ -1,5 +1,8 @@
 #include <fstream>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include "include/vixen/tokens.hpp"
 #include "tests/hounddog.hpp"
 
@@ -26,6 +29,15 @@ namespace test_vixen::tokens {
         hounddog::assert(tokens_find_genname("dummy_symbol") == "NameGeneric", "A non-specific symbol should return 'NameGeneric' as the token type name");
         hounddog::assert(tokens_find_genname("==") == "OperEquals", "'==' shoule return 'OperEquals' as the token type name");
         hounddog::assert(tokens_find_genname(TokenType::KwdDelete) == "KwdDelete", "'TokenType::KwdDelete' should return 'KwdDelete' as the token type name");
+
+        // Names are looked up by indexing, and are
+        // known at compile time.
+        static_assert(tokens_find_genname(TokenType::NumInt) == "NumInt");
+        static_assert(tokens_find_genname(TokenType::CTRLCharEOL) == "CTRLCharEOL");
+        for (auto const& [spelling, type, repr] : TokenSpellings) {
+            std::string_view name = tokens_find_genname(type);
+            hounddog::assert(name == repr, "'{}' should be named {} not {}", spelling, repr, name);
+        }
     }
 
     void test_find_gentype() {
@@ -40,6 +52,24 @@ namespace test_vixen::tokens {
         hounddog::assert(tt == 64, "Must return 'TokenType::OperAttrPtr(64)' not '{}'", tt);
     }
 
+    void test_find_gentype_constexpr() {
+        // Classifying is usable at compile time.
+        static_assert(tokens_find_gentype("while") == TokenType::KwdWhile);
+        static_assert(tokens_find_gentype("//") == TokenType::OperDivFloor);
+        static_assert(tokens_find_gentype("whiles") == TokenType::NameGeneric);
+
+        for (auto const& [spelling, type, repr] : TokenSpellings) {
+            TokenType found = tokens_find_gentype(spelling);
+            hounddog::assert(found == type, "'{}' should be {} not {}", spelling, repr, (uint)found);
+        }
+
+        std::string_view names[] = {"", "w", "whilee", "EOX", "<name", "---", "=>", "classes"};
+        for (auto const& name : names) {
+            TokenType found = tokens_find_gentype(name);
+            hounddog::assert(found == TokenType::NameGeneric, "'{}' should be NameGeneric not {}", name, (uint)found);
+        }
+    }
+
     void test_find_numtype() {
         uint tt;
 
@@ -94,4 +124,372 @@ namespace test_vixen::tokens {
         hounddog::assert(tokens_isinteger(t), "'{}' should be a valid integer token", t.symbol);
         hounddog::assert(!tokens_isgeneric(t), "'{}' should not be a valid name token", t.symbol);
     }
+
+    void test_lexer_noalloc() {
+        Lexer l = setup_lexer();
+        Token t;
+
+        // Symbols are views into the lexer's
+        // source; lexing a whole file must not
+        // allocate per token. Only symbols not
+        // seen before are interned.
+        setup_lexer().tokenize_all();
+        size_t before = hounddog::allocations();
+        while (!l.end())
+            t = l.next();
+        size_t made = hounddog::allocations() - before;
+
+        hounddog::assert(made == 0, "Lexing should not allocate, made {} allocations", made);
+        hounddog::assert(t.type == TokenType::CTRLCharEOF, "Last token should be 'EOF' not '{}'", t.symbol);
+    }
+
+    void test_stream_lexer() {
+        const std::string file_name("examples/test_symbols.vxn");
+        Lexer expected = setup_lexer();
+
+        int fd = open(file_name.c_str(), O_RDONLY);
+        hounddog::assert(fd >= 0, "Could not open test file '{}'", file_name);
+        StreamLexer l(fd, file_name, 5);
+
+        while (!expected.end()) {
+            Token ex = expected.next();
+            Token pr = l.next();
+            hounddog::assert(
+                ex.symbol == pr.symbol && ex.type == pr.type && ex.lineno() == pr.lineno() && ex.column() == pr.column(),
+                "Expected {} got {}", ex.symbol, pr.symbol);
+            hounddog::assert(pr.file() == file_name, "Token should be from '{}' not '{}'", file_name, pr.file());
+        }
+        close(fd);
+    }
+
+    void test_lexer_positions() {
+        // Positions worked out from token offsets
+        // must agree with those the symbol parser
+        // tracks as it goes.
+        const std::string file_name("examples/test_symbols.vxn");
+        ifstream file(file_name);
+        vixen::symbols::RawParser expected(file, file_name);
+        Lexer l = setup_lexer();
+
+        while (!expected.end()) {
+            auto const [lineno, column, symbol] = expected.next();
+            Token pr = l.next();
+            hounddog::assert(
+                lineno == pr.lineno() && column == pr.column(),
+                "Expected '{}' at ({}, {}) not ({}, {})",
+                symbol, lineno, column, pr.lineno(), pr.column());
+        }
+    }
+
+    void test_lexer_next_batch() {
+        Lexer expected = setup_lexer();
+        Lexer l = setup_lexer();
+        Token buffer[5];
+        std::vector<Token> tokens;
+        size_t count;
+
+        // Batches must hand out the same tokens
+        // as lexing one at a time, without
+        // allocating.
+        setup_lexer().tokenize_all();
+        tokens.reserve(1024);
+        size_t before = hounddog::allocations();
+        do {
+            count = l.next_batch(buffer);
+            tokens.insert(tokens.end(), buffer, buffer + count);
+        } while (count == 5);
+        size_t made = hounddog::allocations() - before;
+
+        hounddog::assert(made == 0, "Batch lexing should not allocate, made {} allocations", made);
+        for (auto const& pr : tokens) {
+            Token ex = expected.next();
+            hounddog::assert(
+                ex.symbol == pr.symbol && ex.offset == pr.offset,
+                "Expected {} got {}", ex.symbol, pr.symbol);
+        }
+        hounddog::assert(tokens.back().type == TokenType::CTRLCharEOF, "Last batch should end with 'EOF'.");
+    }
+
+    void test_tokenize_all() {
+        Lexer expected = setup_lexer();
+        TokenList all = setup_lexer().tokenize_all();
+        std::vector<Token>& tokens = all.tokens;
+
+        for (auto const& pr : tokens) {
+            Token ex = expected.next();
+            hounddog::assert(ex.symbol == pr.symbol && ex.type == pr.type, "Expected {} got {}", ex.symbol, pr.symbol);
+        }
+        hounddog::assert(expected.end(), "All tokens should have been lexed.");
+        hounddog::assert(tokens.back().type == TokenType::CTRLCharEOF, "Tokens should end with 'EOF'.");
+        hounddog::assert(tokens[tokens.size() - 2].type != TokenType::CTRLCharEOF, "Tokens should end with only one 'EOF'.");
+    }
+
+    void test_token_stream() {
+        // Names spelled like the end markers must
+        // not end the stream early.
+        std::string data("x = EOF + 1.5;\ns = \"a\nstring\";\nEOL;\n");
+        auto source = vixen::sources::source_from_string(data);
+        std::vector<Token> expected = tokenize_all(source).tokens;
+        TokenStream stream(source);
+
+        hounddog::assert(stream.size() == expected.size(), "Expected {} tokens got {}", expected.size(), stream.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            Token ex = expected[i];
+            Token pr = stream.token(i);
+            hounddog::assert(
+                ex.symbol == pr.symbol && ex.type == pr.type && ex.offset == pr.offset && ex.id == pr.id,
+                "Expected '{}' at {} got '{}' at {}", ex.symbol, ex.offset, pr.symbol, pr.offset);
+            hounddog::assert(ex.lineno() == pr.lineno(), "Expected {} on line {} not {}", ex.symbol, ex.lineno(), pr.lineno());
+        }
+        hounddog::assert(
+            stream.bytes() < expected.size() * sizeof(Token) / 2,
+            "Streams should be compact, {} bytes for {} tokens", stream.bytes(), stream.size());
+
+        // Cursors stay on the last token once
+        // they reach it.
+        TokenStream::Cursor cursor = stream.cursor();
+        TokenStream::Cursor saved  = cursor.peek(2);
+        hounddog::assert(saved.symbol() == "EOF" && saved.type() == TokenType::CTRLCharEOF, "Third token should be the name 'EOF'.");
+        while (!cursor.done())
+            cursor.advance();
+        cursor.advance(4);
+        hounddog::assert(cursor.position() == stream.size() - 1, "Cursor should stay on the last token.");
+        hounddog::assert(cursor.symbol() == "EOF", "Stream should end with 'EOF' not '{}'", cursor.symbol());
+        hounddog::assert(saved.position() == 2, "Saved cursors should not move.");
+    }
+
+    void test_token_stream_numerics() {
+        // Numerics are decoded as they are lexed,
+        // and found again by token index.
+        std::string data("x = 0x_ff + 1.5 * y - 1_000;\n");
+        auto source = vixen::sources::source_from_string(data);
+        TokenStream stream(source);
+
+        hounddog::assert(!stream.numeric(0), "'x' should have no value.");
+        hounddog::assert(stream.numeric(2)->integer.low() == 255, "'0x_ff' should be 255.");
+        hounddog::assert(stream.numeric(4)->floating == 1.5, "'1.5' should be 1.5.");
+        hounddog::assert(stream.cursor(8).numeric()->integer.low() == 1000, "'1_000' should be 1000.");
+
+        std::vector<Token> tokens = tokenize_all(source).tokens;
+        auto table = tokens_decode_numerics(tokens);
+        hounddog::assert(table.size() == 3, "Expected 3 numerics got {}", table.size());
+        hounddog::assert(table.find(8)->integer.low() == 1000, "'1_000' should be 1000.");
+    }
+
+    void test_tokenize_parallel() {
+        // Strings crossing lines, and lines
+        // opening with a string, force slices to
+        // be stitched back together.
+        std::string data;
+        for (int i = 0; i < 64; i++) {
+            data += "x: int = 1 + 2.5;  # comment\n";
+            data += "s = \"a string\n# not a comment\nthat = spans;\n lines\";\n";
+            data += "\"opens\" + '''triple\n'quoted'\n''';\n\n";
+            data += "    '' ;'\n'\n";
+        }
+        auto source = vixen::sources::source_from_string(data);
+        std::vector<Token> expected = tokenize_all(source).tokens;
+
+        for (size_t threads = 2; threads <= 64; threads *= 2) {
+            std::vector<Token> got = tokenize_parallel(source, threads, 1).tokens;
+            hounddog::assert(
+                expected.size() == got.size(),
+                "Expected {} tokens with {} threads, got {}", expected.size(), threads, got.size());
+            for (size_t i = 0; i < got.size(); i++) {
+                hounddog::assert(
+                    expected[i].symbol == got[i].symbol && expected[i].offset == got[i].offset && expected[i].type == got[i].type,
+                    "Expected {} got {} with {} threads", expected[i].symbol, got[i].symbol, threads);
+            }
+        }
+    }
+
+    void test_lexer_interned() {
+        // Equal names and keywords must share an
+        // id, and ids must refer back to their
+        // symbol. Nothing else is interned.
+        std::string data("x = y + x * y; if x; 'x' 1 1;\n");
+        Lexer l(data);
+        std::vector<Token> tokens = l.tokenize_all().tokens;
+        std::erase_if(tokens, [](const Token& token) {
+            if (tokens_isinterned(token.type))
+                return false;
+            hounddog::assert(token.id == 0, "'{}' should not be interned.", token.symbol);
+            return true;
+        });
+        hounddog::assert(tokens.size() == 6, "Expected 6 names and keywords got {}", tokens.size());
+
+        for (auto const& a : tokens) {
+            hounddog::assert(
+                vixen::interner::interner_global().lookup(a.id) == a.symbol,
+                "Id {} should refer back to '{}'", a.id, a.symbol);
+            for (auto const& b : tokens) {
+                hounddog::assert(
+                    (a.id == b.id) == (a.symbol == b.symbol),
+                    "'{}' and '{}' should share an id only if equal.", a.symbol, b.symbol);
+            }
+        }
+    }
+
+    void test_lexer_dfa() {
+        std::string data(
+            "x: int = 0x1f + .5 * 3.14 // a**b <= c->d; # comment\n"
+            "if iffy return \"\"\"str\nx\"\"\" 'a\\'b' \"\" 0b101 0o17 1_000;\n");
+        Lexer l(vixen::sources::source_from_string(data), LexerKind::Dfa);
+
+        std::pair<std::string, TokenType> expected[] = {
+            {"x", TokenType::NameGeneric},
+            {":", TokenType::PuncColon},
+            {"int", TokenType::NameGeneric},
+            {"=", TokenType::OperAssign},
+            {"0x1f", TokenType::NumHex},
+            {"+", TokenType::OperPlus},
+            {".5", TokenType::NumFlt},
+            {"*", TokenType::OperStar},
+            {"3.14", TokenType::NumFlt},
+            {"//", TokenType::OperDivFloor},
+            {"a", TokenType::NameGeneric},
+            {"**", TokenType::OperPower},
+            {"b", TokenType::NameGeneric},
+            {"<=", TokenType::OperLgLte},
+            {"c", TokenType::NameGeneric},
+            {"->", TokenType::OperPtrAttr},
+            {"d", TokenType::NameGeneric},
+            {";", TokenType::PuncTerminator},
+            {"if", TokenType::KwdIf},
+            {"iffy", TokenType::NameGeneric},
+            {"return", TokenType::KwdReturn},
+            {"\"\"\"", TokenType::StrTripleDbl},
+            {"str\nx", TokenType::StrExpression},
+            {"\"\"\"", TokenType::StrTripleDbl},
+            {"'", TokenType::StrSingleSgl},
+            {"a\\'b", TokenType::StrExpression},
+            {"'", TokenType::StrSingleSgl},
+            {"\"", TokenType::StrSingleDbl},
+            {"\"", TokenType::StrSingleDbl},
+            {"0b101", TokenType::NumBin},
+            {"0o17", TokenType::NumOct},
+            {"1_000", TokenType::NumInt},
+            {";", TokenType::PuncTerminator},
+            {"EOF", TokenType::CTRLCharEOF},
+        };
+
+        for (auto const& [symbol, type] : expected) {
+            Token t = l.next();
+            hounddog::assert(
+                t.symbol == symbol && t.type == type,
+                "Expected '{}' ({}) got '{}' ({})", symbol, (uint)type, t.symbol, (uint)t.type);
+        }
+        hounddog::assert(l.end(), "Lexer should be exhausted.");
+    }
+
+    void test_lexer_dfa_agrees() {
+        // Both kinds of lexer must agree on
+        // ordinary code, spaced or not.
+        std::string data(
+            "x + y * (z - 1);\n"
+            "alpha // 2 + beta % 3 - gamma ** 4;\n"
+            "if (a <= b) { return c.d; } # comment\n"
+            "func main(): int { x, y: int; x = 88; }\n"
+            "x=y+(z*1)//2;a.b[c]+=1.5;f(a,b);\n"
+            "if(a<=b){return c->d;}s=f(\"q\");t=0.5**x;\n");
+        auto source = vixen::sources::source_from_string(data);
+        Lexer expected(source);
+        Lexer l(source, LexerKind::Dfa);
+
+        while (!expected.end()) {
+            Token ex = expected.next();
+            Token pr = l.next();
+            hounddog::assert(
+                ex.symbol == pr.symbol && ex.type == pr.type && ex.offset == pr.offset,
+                "Expected '{}' got '{}'", ex.symbol, pr.symbol);
+        }
+        hounddog::assert(l.end(), "Both lexers should be exhausted together.");
+    }
+
+    // Symbols and type names of the tokens in
+    // `data`, up to the end of input.
+    std::string setup_lexed(const std::string& data, LexerKind kind) {
+        auto source = vixen::sources::source_from_string(data);
+        Lexer l(source, kind);
+        std::string out;
+        while (1) {
+            Token t = l.next();
+            if (tokens_isend(t.type))
+                return out;
+            if (!out.empty())
+                out.append(" ");
+            out.append(t.symbol).append(":").append(tokens_find_genname(t.type));
+        }
+    }
+
+    void test_lexer_dfa_differs() {
+        // Where unspaced runs of chars are not
+        // spellings, the two kinds of lexer differ
+        // as `LexerKind::Dfa` describes.
+        struct Case {
+            std::string data;
+            std::string symbols;
+            std::string dfa;
+        };
+        Case cases[] = {
+            {"|=",    "|=:NameGeneric",   "|:OperBtOr =:OperAssign"},
+            {"?,",    "?,:NameGeneric",   "?:OperAsk ,:PuncComma"},
+            {"x**-2", "x:NameGeneric **-:NameGeneric 2:NumInt", "x:NameGeneric **:OperPower -:OperMinus 2:NumInt"},
+            {"*\"a\"", "*\":NameGeneric a:NameGeneric \":StrSingleDbl", "*:OperStar \":StrSingleDbl a:StrExpression \":StrSingleDbl"},
+            {"$",     "$:NameGeneric",    "$:ErrorUnknown"},
+            {"0a",    "0a:NameGeneric",   "0:NumInt a:NameGeneric"},
+            {"1.5w",  "1.5w:NameGeneric", "1.5:NumFlt w:NameGeneric"},
+            {"1x",    "1x:NumInt",        "1:NumInt x:NameGeneric"},
+            {"0x1fb", "0x1fb:NameGeneric", "0x1fb:NumHex"},
+            {"-1",    "-1:NumInt",        "-:OperMinus 1:NumInt"},
+            {"x0",    "x0:NumInt",        "x0:NameGeneric"},
+        };
+
+        for (const Case& c : cases) {
+            std::string symbols = setup_lexed(c.data, LexerKind::Symbols);
+            std::string dfa     = setup_lexed(c.data, LexerKind::Dfa);
+            hounddog::assert(symbols == c.symbols, "Symbols lexed '{}' as '{}' not '{}'", c.data, symbols, c.symbols);
+            hounddog::assert(dfa == c.dfa, "DFA lexed '{}' as '{}' not '{}'", c.data, dfa, c.dfa);
+        }
+    }
+
+    void test_lexer_dfa_escapes() {
+        // Both kinds of lexer close a string at a
+        // delimiter after an even number of '\\',
+        // and only there.
+        std::string data(
+            "x = \"a\\\\\"; y;\n"
+            "s = 'b\\'c'; t = \"d\\\\\\\"e\";\n"
+            "u = \"\\\\\\\\\" + '''f\\'''g''';\n");
+        auto source = vixen::sources::source_from_string(data);
+        Lexer expected(source);
+        Lexer l(source, LexerKind::Dfa);
+
+        size_t count = 0;
+        while (!expected.end()) {
+            Token ex = expected.next();
+            Token pr = l.next();
+            hounddog::assert(
+                ex.symbol == pr.symbol && ex.type == pr.type && ex.offset == pr.offset,
+                "Expected '{}' ({}) got '{}' ({})", ex.symbol, (uint)ex.type, pr.symbol, (uint)pr.type);
+            count++;
+        }
+        hounddog::assert(l.end(), "Both lexers should be exhausted together.");
+        hounddog::assert(count == 31, "Expected 31 tokens got {}", count);
+    }
+
+    void test_lexer_dfa_end() {
+        // Lines ended within a string count
+        // toward how input ends, for both kinds
+        // of lexer.
+        std::string data("s = \"a\nb\"; t");
+        auto source = vixen::sources::source_from_string(data);
+
+        for (LexerKind kind : {LexerKind::Symbols, LexerKind::Dfa}) {
+            Lexer l(source, kind);
+            std::vector<Token> tokens = l.tokenize_all().tokens;
+            hounddog::assert(tokens.back().type == TokenType::CTRLCharEOF, "Expected 'EOF' got '{}'", tokens.back().symbol);
+            hounddog::assert(l.lineno() == 2, "Expected to end on line 2 got {}", l.lineno());
+        }
+    }
 }
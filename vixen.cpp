@@ -14,6 +14,7 @@ struct VixenNamespace {
     std::string cinput;
     std::string exec;
     std::string file;
+    std::string tokens;
     bool        help;
     bool        version;
 };
@@ -21,8 +22,11 @@ struct VixenNamespace {
 void usage(VixenNamespace vxn) {
     std::cout
         << "usage: " << vxn.exec << " [file?] [OPTIONS]\n"
+           "Reads from stdin when file is '-'.\n"
            "Options:\n"
            "-c           Interperate input.\n"
+           "-t/--tokens  Cache tokens at path, reused\n"
+           "             while the input is unchanged.\n"
            "-h/--help    Print help and exit.\n"
            "-V/--version Print exec version."
         << std::endl;
@@ -69,11 +73,12 @@ void parse(VixenNamespace& vxn, int argc, const char* argv[]) {
     vxn.cinput  = std::string();
     vxn.exec    = std::string(argv[0]);
     vxn.file    = std::string();
+    vxn.tokens  = std::string();
     vxn.help    = false;
     vxn.version = false;
 
     std::vector<std::string_view> args(argv + 1, argv + argc);
-    std::string short_opts("Vch");
+    std::string short_opts("Vcht");
     bool skipping = false;
     for (const auto& arg : args) {
         if (skipping) {
@@ -98,9 +103,16 @@ void parse(VixenNamespace& vxn, int argc, const char* argv[]) {
             skipping = true;
             continue;
         }
+        if (arg == "-t" || arg == "--tokens") {
+            vxn.tokens = parse_option(args, arg);
+            if (!vxn.tokens.length())
+                panic(vxn, "Option '" + std::string(arg) + "' expects a path.");
+            skipping = true;
+            continue;
+        }
         // If the argument looks like an option
         // but we cannot identify it, bail.
-        if (arg.find('-') >= 0 && arg.find('-') < 2) {
+        if (arg != "-" && arg.find('-') >= 0 && arg.find('-') < 2) {
             panic(vxn, "Unknown option: '" + std::string(arg) + "'.");
         }
 
@@ -127,9 +139,8 @@ void parse(VixenNamespace& vxn, int argc, const char* argv[]) {
 }
 
 int main(int argc, const char* argv[]) {
-    tokens::Lexer      lexer;
     parser::TreeParser parser;
-    nodes::TreeNode    program;
+    nodes::Tree        program;
 
     VixenNamespace vxn;
     parse(vxn, argc, argv);
@@ -140,27 +151,52 @@ int main(int argc, const char* argv[]) {
             std::cout << ">>> ";
             std::getline(std::cin, user_in);
 
-            parser = parser::TreeParser(tokens::Lexer(user_in));
-            std::cout
-                << parser::parse(parser)
-                << std::endl;
+            parser  = parser::TreeParser(tokens::Lexer(user_in));
+            program = parser::parse(parser);
+            std::cerr << program.diagnostics;
+            std::cout << program << std::endl;
         }
     } else {
         // Interperate code provided from cli or
         // from file path.
-        if (vxn.file.length()) {
-            ifstream file(vxn.file);
-            if (!file.is_open())
+        // Files are mapped and lexed in place,
+        // '-' reads from stdin instead.
+        sources::SourceRef source;
+        if (vxn.file == "-") {
+            source = sources::source_from_fd(STDIN_FILENO, "<stdin>");
+            if (!source)
+                panic(vxn, "Cannot read from stdin.");
+        } else if (vxn.file.length()) {
+            source = sources::source_open(vxn.file);
+            if (!source)
                 panic(vxn, "Cannot open file '" + vxn.file + "'.");
-            lexer = tokens::Lexer(file, vxn.file);
-            file.close();
         } else if (vxn.cinput.length()) {
-            lexer = tokens::Lexer(vxn.cinput);
+            source = sources::source_from_string(vxn.cinput);
+        }
+
+        // Tokens cached by an earlier run over the
+        // same input are mapped and used as is,
+        // otherwise they are lexed and cached.
+        if (vxn.tokens.length()) {
+            std::shared_ptr<const tokens::TokenStream> stream = cache::cache_load(source, vxn.tokens);
+            if (!stream) {
+                auto lexed = std::make_shared<tokens::TokenStream>(source);
+                if (!cache::cache_write(*lexed, vxn.tokens))
+                    print_error(vxn, "Cannot write token cache '{}'.", vxn.tokens);
+                stream = lexed;
+            }
+            parser = parser::TreeParser(stream);
+        } else {
+            parser = parser::TreeParser(tokens::Lexer(source));
         }
 
-        parser  = parser::TreeParser(lexer);
+        // Every error in the input is reported,
+        // not only the first.
         program = parser::parse(parser);
+        std::cerr << program.diagnostics;
         std::cout << program << std::endl;
+        if (!program.diagnostics.empty())
+            return 1;
     }
 
     return 0;
@@ -0,0 +1,47 @@
+#include "benches/bench.hpp"
+#include "benches/vixen.hpp"
+
+int main(int argc, const char* argv[]) {
+    bench::BenchRunStats brs;
+
+    // Vixen Front End Benchmarks.
+    // ------------------------------------------
+    // Benchmarks are run over a corpus built
+    // from our example and grammar sources, so
+    // must be run from the project root.
+    bench::add_bench(brs, "symbols::parser_throughput", bench_vixen::symbols::bench_parser_throughput);
+    bench::add_bench(brs, "sources::source_open", bench_vixen::sources::bench_source_open);
+    bench::add_bench(brs, "symbols::parser_skipping", bench_vixen::symbols::bench_parser_skipping);
+    bench::add_bench(brs, "symbols::parser_numerics", bench_vixen::symbols::bench_parser_numerics);
+    bench::add_bench(brs, "symbols::parser_strings", bench_vixen::symbols::bench_parser_strings);
+    bench::add_bench(brs, "tokens::lexer_throughput", bench_vixen::tokens::bench_lexer_throughput);
+    bench::add_bench(brs, "tokens::find_gentype", bench_vixen::tokens::bench_find_gentype);
+    bench::add_bench(brs, "tokens::token_stream", bench_vixen::tokens::bench_token_stream);
+    bench::add_bench(brs, "tokens::lexer_dfa", bench_vixen::tokens::bench_lexer_dfa);
+    bench::add_bench(brs, "tokens::lexer_batch", bench_vixen::tokens::bench_lexer_batch);
+    bench::add_bench(brs, "tokens::lexer_parallel", bench_vixen::tokens::bench_lexer_parallel);
+    bench::add_bench(brs, "tokens::lexer_dispatch", bench_vixen::tokens::bench_lexer_dispatch);
+    bench::add_bench(brs, "parser::parser_dispatch", bench_vixen::parser::bench_parser_dispatch);
+    bench::add_bench(brs, "parser::parser_arena", bench_vixen::parser::bench_parser_arena);
+    bench::add_bench(brs, "parser::parser_flat", bench_vixen::parser::bench_parser_flat);
+    bench::add_bench(brs, "parser::parser_deep", bench_vixen::parser::bench_parser_deep);
+    bench::add_bench(brs, "cache::cache_load", bench_vixen::cache::bench_cache_load);
+    bench::add_bench(brs, "incremental::edit_latency", bench_vixen::incremental::bench_edit_latency);
+
+    switch (argc) {
+        case 1:
+            bench::attempt(brs, "*");
+            break;
+        case 2:
+            bench::attempt(brs, argv[1]);
+            break;
+        default:
+            std::cerr
+                << "error: "
+                << argv[0] << " accepts 1 or 0 arguments (pattern?)"
+                << std::endl;
+            return 1;
+    }
+
+    return 0;
+}
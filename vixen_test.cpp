@@ -24,6 +24,7 @@ int main(int argc, const char* argv[]) {
     // foundation of our front-end. Without them,
     // our language might as well not work at all.
     hounddog::add_test(trs, "symbols::string_has_char", test_vixen::symbols::test_string_contains_char);
+    hounddog::add_test(trs, "symbols::char_class_table", test_vixen::symbols::test_char_class_table);
     hounddog::add_test(trs, "symbols::char_iscommment", test_vixen::symbols::test_char_iscomment);
     hounddog::add_test(trs, "symbols::char_isdigitchar", test_vixen::symbols::test_char_isdigitchar);
     hounddog::add_test(trs, "symbols::char_isdigittext", test_vixen::symbols::test_char_isdigittext);
@@ -42,10 +43,40 @@ int main(int argc, const char* argv[]) {
     hounddog::add_test(trs, "symbols::symbol_istermed", test_vixen::symbols::test_symbol_istermed);
     hounddog::add_test(trs, "symbols::symbol_next_isvalidname", test_vixen::symbols::test_symbol_next_isvalidname);
     hounddog::add_test(trs, "symbols::symbol_next_isvalidnum", test_vixen::symbols::test_symbol_next_isvalidnum);
+    hounddog::add_test(trs, "symbols::numeric_scan", test_vixen::symbols::test_numeric_scan);
     hounddog::add_test(trs, "symbols::parser_no_error", test_vixen::symbols::test_parser_no_error);
     hounddog::add_test(trs, "symbols::parser_no_whitespace", test_vixen::symbols::test_parser_nowhitespace);
     hounddog::add_test(trs, "symbols::parser_no_comment", test_vixen::symbols::test_parser_nocomment);
+    hounddog::add_test(trs, "symbols::parser_skip_indented", test_vixen::symbols::test_parser_skip_indented);
+    hounddog::add_test(trs, "symbols::parser_numeric_long", test_vixen::symbols::test_parser_numeric_long);
+    hounddog::add_test(trs, "symbols::parser_string_long", test_vixen::symbols::test_parser_string_long);
     hounddog::add_test(trs, "symbols::parser_parse_expected", test_vixen::symbols::test_parser_parse_expected);
+    hounddog::add_test(trs, "symbols::stream_parser_expected", test_vixen::symbols::test_stream_parser_expected);
+    hounddog::add_test(trs, "symbols::stream_parser_bounded", test_vixen::symbols::test_stream_parser_bounded);
+    hounddog::add_test(trs, "symbols::stream_parser_empty", test_vixen::symbols::test_stream_parser_empty);
+    hounddog::add_test(trs, "symbols::stream_parser_read_error", test_vixen::symbols::test_stream_parser_read_error);
+    hounddog::add_test(trs, "symbols::dynamic_parser_expected", test_vixen::symbols::test_dynamic_parser_expected);
+    hounddog::add_test(trs, "sources::source_open", test_vixen::sources::test_source_open);
+    hounddog::add_test(trs, "sources::source_open_missing", test_vixen::sources::test_source_open_missing);
+    hounddog::add_test(trs, "sources::source_from_fd", test_vixen::sources::test_source_from_fd);
+    hounddog::add_test(trs, "sources::source_newline", test_vixen::sources::test_source_newline);
+    hounddog::add_test(trs, "sources::lexer_mapped", test_vixen::sources::test_lexer_mapped);
+    hounddog::add_test(trs, "sources::line_index", test_vixen::sources::test_line_index);
+    hounddog::add_test(trs, "sources::source_registry", test_vixen::sources::test_source_registry);
+    hounddog::add_test(trs, "dfa::automaton_accept", test_vixen::dfa::test_automaton_accept);
+    hounddog::add_test(trs, "dfa::automaton_reject", test_vixen::dfa::test_automaton_reject);
+    hounddog::add_test(trs, "numerics::decode_integer", test_vixen::numerics::test_decode_integer);
+    hounddog::add_test(trs, "numerics::decode_wide", test_vixen::numerics::test_decode_wide);
+    hounddog::add_test(trs, "numerics::decode_float", test_vixen::numerics::test_decode_float);
+    hounddog::add_test(trs, "cache::cache_roundtrip", test_vixen::cache::test_cache_roundtrip);
+    hounddog::add_test(trs, "cache::cache_stale", test_vixen::cache::test_cache_stale);
+    hounddog::add_test(trs, "interner::intern", test_vixen::interner::test_intern);
+    hounddog::add_test(trs, "interner::intern_large", test_vixen::interner::test_intern_large);
+    hounddog::add_test(trs, "interner::intern_threaded", test_vixen::interner::test_intern_threaded);
+    hounddog::add_test(trs, "simd::byte_isspace", test_vixen::simd::test_byte_isspace);
+    hounddog::add_test(trs, "simd::skip_space", test_vixen::simd::test_skip_space);
+    hounddog::add_test(trs, "simd::skip_line", test_vixen::simd::test_skip_line);
+    hounddog::add_test(trs, "simd::index_newlines", test_vixen::simd::test_index_newlines);
 
     // Vixen Token Parsing Suite.
     // ------------------------------------------
@@ -60,10 +91,52 @@ int main(int argc, const char* argv[]) {
     hounddog::add_test(trs, "tokens::mapper_find_errunk", test_vixen::tokens::test_find_errunk);
     hounddog::add_test(trs, "tokens::mapper_find_genname", test_vixen::tokens::test_find_genname);
     hounddog::add_test(trs, "tokens::mapper_find_gentype", test_vixen::tokens::test_find_gentype);
+    hounddog::add_test(trs, "tokens::mapper_find_gentype_constexpr", test_vixen::tokens::test_find_gentype_constexpr);
     hounddog::add_test(trs, "tokens::mapper_find_numtype", test_vixen::tokens::test_find_numtype);
     hounddog::add_test(trs, "tokens::lexer_parse_isfloat", test_vixen::tokens::test_isfloat);
     hounddog::add_test(trs, "tokens::lexer_parse_isgeneric", test_vixen::tokens::test_isgeneric);
     hounddog::add_test(trs, "tokens::lexer_parse_isinteger", test_vixen::tokens::test_isinteger);
+    hounddog::add_test(trs, "tokens::lexer_noalloc", test_vixen::tokens::test_lexer_noalloc);
+    hounddog::add_test(trs, "tokens::stream_lexer", test_vixen::tokens::test_stream_lexer);
+    hounddog::add_test(trs, "tokens::lexer_positions", test_vixen::tokens::test_lexer_positions);
+    hounddog::add_test(trs, "tokens::lexer_next_batch", test_vixen::tokens::test_lexer_next_batch);
+    hounddog::add_test(trs, "tokens::tokenize_all", test_vixen::tokens::test_tokenize_all);
+    hounddog::add_test(trs, "tokens::token_stream", test_vixen::tokens::test_token_stream);
+    hounddog::add_test(trs, "tokens::token_stream_numerics", test_vixen::tokens::test_token_stream_numerics);
+    hounddog::add_test(trs, "tokens::tokenize_parallel", test_vixen::tokens::test_tokenize_parallel);
+    hounddog::add_test(trs, "tokens::lexer_interned", test_vixen::tokens::test_lexer_interned);
+    hounddog::add_test(trs, "tokens::lexer_dfa", test_vixen::tokens::test_lexer_dfa);
+    hounddog::add_test(trs, "tokens::lexer_dfa_agrees", test_vixen::tokens::test_lexer_dfa_agrees);
+    hounddog::add_test(trs, "tokens::lexer_dfa_differs", test_vixen::tokens::test_lexer_dfa_differs);
+    hounddog::add_test(trs, "tokens::lexer_dfa_escapes", test_vixen::tokens::test_lexer_dfa_escapes);
+    hounddog::add_test(trs, "tokens::lexer_dfa_end", test_vixen::tokens::test_lexer_dfa_end);
+
+    // Vixen Tree Parsing Suite.
+    // ------------------------------------------
+    // Builds syntax trees from the tokens
+    // produced by the suite above.
+    hounddog::add_test(trs, "parser::parse_dynamic", test_vixen::parser::test_parse_dynamic);
+    hounddog::add_test(trs, "parser::parse_keeps_source", test_vixen::parser::test_parse_keeps_source);
+    hounddog::add_test(trs, "parser::parse_node_types", test_vixen::parser::test_parse_node_types);
+    hounddog::add_test(trs, "parser::parse_arena", test_vixen::parser::test_parse_arena);
+    hounddog::add_test(trs, "parser::parse_flat", test_vixen::parser::test_parse_flat);
+    hounddog::add_test(trs, "parser::parse_flat_deep", test_vixen::parser::test_parse_flat_deep);
+    hounddog::add_test(trs, "parser::parse_print_deep", test_vixen::parser::test_parse_print_deep);
+    hounddog::add_test(trs, "parser::parse_numerics", test_vixen::parser::test_parse_numerics);
+    hounddog::add_test(trs, "parser::parse_precedence", test_vixen::parser::test_parse_precedence);
+    hounddog::add_test(trs, "parser::parser_lookahead", test_vixen::parser::test_parser_lookahead);
+    hounddog::add_test(trs, "parser::parser_isdeclaration", test_vixen::parser::test_parser_isdeclaration);
+    hounddog::add_test(trs, "parser::parser_rewind", test_vixen::parser::test_parser_rewind);
+    hounddog::add_test(trs, "parser::parser_rewind_boundary", test_vixen::parser::test_parser_rewind_boundary);
+    hounddog::add_test(trs, "parser::parser_rewind_released", test_vixen::parser::test_parser_rewind_released);
+    hounddog::add_test(trs, "parser::parser_memoized", test_vixen::parser::test_parser_memoized);
+    hounddog::add_test(trs, "parser::parse_recovery", test_vixen::parser::test_parse_recovery);
+    hounddog::add_test(trs, "parser::parse_recovery_end", test_vixen::parser::test_parse_recovery_end);
+    hounddog::add_test(trs, "parser::parse_empty_statement", test_vixen::parser::test_parse_empty_statement);
+    hounddog::add_test(trs, "incremental::edit_reuse", test_vixen::incremental::test_edit_reuse);
+    hounddog::add_test(trs, "incremental::edit_random", test_vixen::incremental::test_edit_random);
+    hounddog::add_test(trs, "incremental::edit_outside", test_vixen::incremental::test_edit_outside);
+    hounddog::add_test(trs, "incremental::edit_deep", test_vixen::incremental::test_edit_deep);
 
     // Current driver code.
     switch (argc) {
@@ -20,7 +20,8 @@ Available Tasks:
 build         Build this project executable, libs & tests.
 build_release Build a release version of executable, libs & tests
 clean         Remove files generated from build system.
-test          Run tests [accepts ID pattern]."
+test          Run tests [accepts ID pattern].
+bench         Run benchmarks [accepts ID pattern]."
 }
 
 echo_performance() {
@@ -51,6 +52,11 @@ test() {
     echo_performance test && time build/vixen_test $@
 }
 
+bench() {
+    build
+    echo_performance bench && build/vixen_bench $@
+}
+
 if [[ $# = 0 ]];
 then
     echo_help
@@ -64,10 +70,10 @@ while [ $# -gt 0 ]; do
         exit 1
     fi
 
-    # If there is an argument following 'test'
-    # target, consume that argument as the test id
-    # pattern.
-    if [[ $1 = 'test' && $# -gt 1 ]]; then
+    # If there is an argument following 'test' or
+    # 'bench' target, consume that argument as the
+    # test id pattern.
+    if [[ ($1 = 'test' || $1 = 'bench') && $# -gt 1 ]]; then
         $1 $2
         shift
     # Treat any other target as a no-args target.